@@ -0,0 +1,48 @@
+# src/cache/plan_cache.py
+# Compiled motion plans, one per token, so motion_io encodes a script once
+# instead of on every send.
+
+import threading
+
+PLAN_CACHE_SIZE = 512  # tokens; well above the seeded signs + letters + rests
+
+
+class PlanCache:
+    """
+    token -> plan built by a compile function from that token's script.
+
+    An entry is only reused for the very script object it was compiled from,
+    so a sign re-fetched after a DB refresh (a new document) is recompiled
+    without anyone having to invalidate it. Scripts that never change
+    (fingerspelling letters, rests) are module constants and hit every time.
+    """
+
+    def __init__(self, size=PLAN_CACHE_SIZE):
+        self.size = size
+        self.entries = {}  # token -> (script, plan), oldest first
+        self.lock = threading.Lock()
+
+    def get(self, script, compile_plan):
+        token = script.get("token")
+        with self.lock:
+            entry = self.entries.get(token)
+            if entry is not None and entry[0] is script:
+                return entry[1]
+        plan = compile_plan(script)
+        with self.lock:
+            self.entries.pop(token, None)
+            if len(self.entries) >= self.size:
+                del self.entries[next(iter(self.entries))]
+            self.entries[token] = (script, plan)
+        return plan
+
+    def invalidate(self, token=None):
+        """Drop one token's plan, or every plan."""
+        with self.lock:
+            if token is None:
+                self.entries.clear()
+            else:
+                self.entries.pop(token, None)
+
+
+PLAN_CACHE = PlanCache()
@@ -0,0 +1,47 @@
+# src/cache/verdict_cache.py
+# Safety verdicts for outgoing scripts (src/fk_tool/precheck.py), keyed by
+# content, so motion_io checks each version of a script once.
+
+import threading
+
+from src.io.motion_frames import script_digest
+
+VERDICT_CACHE_SIZE = 1024  # script versions; several per sign survive a few DB edits
+
+
+class VerdictCache:
+    """
+    script_digest(script) -> verdict built by a check function from that script.
+
+    Unlike PlanCache this goes by content, not by object: a sign re-fetched
+    after a DB refresh hits as long as its keyframes are unchanged, and an
+    edited sign is checked again because its digest moves.
+    """
+
+    def __init__(self, size=VERDICT_CACHE_SIZE):
+        self.size = size
+        self.entries = {}  # digest -> verdict, oldest first
+        self.lock = threading.Lock()
+
+    def get(self, script, check):
+        digest = script_digest(script)
+        with self.lock:
+            verdict = self.entries.pop(digest, None)
+            if verdict is not None:
+                self.entries[digest] = verdict
+                return verdict
+        verdict = check(script)
+        with self.lock:
+            self.entries.pop(digest, None)
+            if len(self.entries) >= self.size:
+                del self.entries[next(iter(self.entries))]
+            self.entries[digest] = verdict
+        return verdict
+
+    def invalidate(self):
+        """Drop every verdict (e.g. after the limit tables change)."""
+        with self.lock:
+            self.entries.clear()
+
+
+VERDICT_CACHE = VerdictCache()
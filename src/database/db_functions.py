@@ -5,6 +5,12 @@ def get_sign_by_token(token: str):
     collection = DatabaseConnection.get_collection()
     return collection.find_one({"token": token.upper()})
 
+# Return the sign documents for many tokens in one query, keyed by upper-cased token.
+def get_signs_by_tokens(tokens):
+    collection = DatabaseConnection.get_collection()
+    keys = list({t.upper() for t in tokens})
+    return {doc["token"]: doc for doc in collection.find({"token": {"$in": keys}})}
+
 # Insert new sign document into DB.
 def insert_sign(sign_data: dict):
     collection = DatabaseConnection.get_collection()
@@ -1,17 +1,19 @@
 """
 Command-line interface for the FK tool.
 
-Provides `evaluate`, `visualize`, and `compare` subcommands via argparse.
+Provides `evaluate`, `visualize`, `compare`, and `compile` subcommands via argparse.
 """
 
 from __future__ import annotations
 
 import argparse
 import sys
+from pathlib import Path
 
+from . import config
 from .loaders import load_from_json, load_from_mongodb, load_from_ai_output
 from .sign_parser import parse_signs
-from .evaluator import evaluate_batch, compare_batch
+from .evaluator import evaluate_batch, evaluate_sign, compare_batch
 from .report import (
     print_console_summary,
     export_report,
@@ -19,6 +21,7 @@ from .report import (
     export_comparison_report,
 )
 from .servo_mapper import servos_to_joint_angles
+from .trajectory import compile_sign, encode_trajectory
 from .visualizer import plot_single_pose, animate_sign
 
 
@@ -37,6 +40,7 @@ def main(argv: list[str] | None = None) -> None:
     _build_evaluate_parser(subparsers)
     _build_visualize_parser(subparsers)
     _build_compare_parser(subparsers)
+    _build_compile_parser(subparsers)
 
     args = parser.parse_args(argv)
 
@@ -46,6 +50,8 @@ def main(argv: list[str] | None = None) -> None:
         _run_visualize(args)
     elif args.command == "compare":
         _run_compare(args)
+    elif args.command == "compile":
+        _run_compile(args)
 
 
 # ---------------------------------------------------------------------------
@@ -81,6 +87,10 @@ def _build_evaluate_parser(subparsers: argparse._SubParsersAction) -> None:
     evaluate_parser.add_argument(
         "--report", default=None, help="Path to save report (.csv or .html)",
     )
+    evaluate_parser.add_argument(
+        "--workers", type=int, default=1,
+        help="Worker processes for evaluation (default: 1, in-process)",
+    )
 
 
 def _build_visualize_parser(subparsers: argparse._SubParsersAction) -> None:
@@ -141,6 +151,45 @@ def _build_compare_parser(subparsers: argparse._SubParsersAction) -> None:
     )
 
 
+def _build_compile_parser(subparsers: argparse._SubParsersAction) -> None:
+    """Add the 'compile' subcommand to the parser.
+
+    Args:
+        subparsers: The subparsers action to add to.
+    """
+    compile_parser = subparsers.add_parser(
+        "compile", help="Compile signs into fixed-rate setpoint streams (.traj)",
+    )
+
+    source_group = compile_parser.add_mutually_exclusive_group(required=True)
+    source_group.add_argument(
+        "--input", default=None, help="Path to signs JSON file",
+    )
+    source_group.add_argument(
+        "--source", choices=["mongodb"], default=None,
+        help="Load signs from MongoDB instead of a file",
+    )
+
+    compile_parser.add_argument(
+        "--token", default=None, help="Compile only this specific sign token",
+    )
+    compile_parser.add_argument(
+        "--tokens", nargs="+", default=None,
+        help="Compile only these sign tokens (multiple, for MongoDB source)",
+    )
+    compile_parser.add_argument(
+        "--rate", type=int, default=config.TRAJECTORY_RATE_HZ,
+        help=f"Setpoints per second (default: {config.TRAJECTORY_RATE_HZ})",
+    )
+    compile_parser.add_argument(
+        "--out", required=True, help="Directory to write <TOKEN>.traj files to",
+    )
+    compile_parser.add_argument(
+        "--force", action="store_true",
+        help="Write signs even if evaluation or the collision check fails",
+    )
+
+
 # ---------------------------------------------------------------------------
 # Data loading helpers
 # ---------------------------------------------------------------------------
@@ -200,7 +249,7 @@ def _run_evaluate(args: argparse.Namespace) -> None:
             sys.exit(1)
 
     print(f"Evaluating {len(parsed_signs)} sign(s)...")
-    evaluations = evaluate_batch(parsed_signs)
+    evaluations = evaluate_batch(parsed_signs, workers=args.workers)
 
     print_console_summary(evaluations)
 
@@ -266,6 +315,48 @@ def _run_compare(args: argparse.Namespace) -> None:
         export_comparison_report(comparisons, args.report)
 
 
+def _run_compile(args: argparse.Namespace) -> None:
+    """Execute the compile subcommand.
+
+    Args:
+        args: Parsed arguments.
+    """
+    raw_signs = _load_signs_from_args(args)
+    parsed_signs = parse_signs(raw_signs)
+
+    tokens_filter = _collect_token_filters(args)
+    if tokens_filter and args.source != "mongodb":
+        parsed_signs = [s for s in parsed_signs if s.token in tokens_filter]
+        if not parsed_signs:
+            print(f"Error: Token(s) {', '.join(tokens_filter)} not found.")
+            sys.exit(1)
+
+    out_dir = Path(args.out)
+    out_dir.mkdir(parents=True, exist_ok=True)
+
+    written = 0
+    for sign in parsed_signs:
+        compiled = compile_sign(sign, rate_hz=args.rate)
+        failures = [issue.message for issue in evaluate_sign(sign).errors]
+        failures += [issue.message for issue in compiled.issues if issue.level == "FAIL"]
+        for issue in compiled.issues:
+            if issue.level == "WARN":
+                print(f"  WARN {sign.token}: {issue.message}")
+        if failures and not args.force:
+            print(f"  SKIP {sign.token}: {failures[0]}")
+            continue
+
+        blob = encode_trajectory(compiled, sign.raw)
+        (out_dir / f"{sign.token}.traj").write_bytes(blob)
+        written += 1
+        print(
+            f"  {sign.token}: {len(compiled.times)} samples @ {compiled.rate_hz} Hz, "
+            f"{compiled.duration:.2f}s, {len(blob)} bytes"
+        )
+
+    print(f"Compiled {written}/{len(parsed_signs)} sign(s) into {out_dir}")
+
+
 def _plot_first_keyframe(sign, save_path: str | None) -> None:
     """Plot the first keyframe of a sign as a static pose.
 
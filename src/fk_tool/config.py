@@ -145,6 +145,50 @@ MAX_ANGULAR_VELOCITY_DEG_PER_SEC: float = 500.0  # Physical servo speed limit
 MIN_SIGN_DURATION_SEC: float = 0.3   # Shortest reasonable sign
 MAX_SIGN_DURATION_SEC: float = 5.0   # Longest reasonable sign
 
+# ---------------------------------------------------------------------------
+# Trajectory compiler (compile subcommand)
+# ---------------------------------------------------------------------------
+
+TRAJECTORY_RATE_HZ: int = 100          # setpoints per second in a compiled stream
+TRAJECTORY_SETTLE_MAX_SEC: float = 2.0  # extra samples allowed for lagging joints to land
+
+# Per-channel speed / acceleration limits, mirroring the firmware's
+# *_MAX_SPEED / *_ACCEL (deg/s, deg/s^2). Shoulders: SHOULDER_MAX_SPEED and
+# SHOULDER_ACCEL (steps) over each axis's steps per degree in arm_traits.h.
+# Order follows the wire fields: hand (5), wrist (2), elbow (1), shoulder (2).
+CHANNEL_MAX_SPEED_DEG_PER_SEC: list[float] = [700.0] * 5 + [500.0] * 2 + [350.0] + [6000.0 / 320.0, 6000.0 / 222.22]
+CHANNEL_ACCEL_DEG_PER_SEC2: list[float] = [8000.0] * 5 + [5000.0] * 2 + [3000.0] + [5000.0 / 320.0, 5000.0 / 222.22]
+
+# Pose an arm holds on the channels a sign leaves unset: the rest pose the
+# controllers return to (bakeRestPose in arm_controller.cpp, REST_LEFT /
+# REST_RIGHT in src/cache/rest_cache.py). Script units, wire order.
+CHANNEL_REST_POSE: list[float] = [90.0] * 8 + [0.0, 0.0]
+
+# Script shoulder angles (rotation, elevation) are degrees from the pose the
+# steppers power up in, arms hanging at the sides. The FK calibration's servo
+# frame has that pose at shoulder neutral_servo_deg, so this is added to the
+# shoulder channels before servo_array_to_joint_angles.
+SHOULDER_HOME_SERVO_DEG: list[float] = [90.0, 90.0]
+
+# Self-collision geometry (inches, body frame: x across, y forward, z up).
+# ACTION ITEM: measure the torso shell.
+TORSO_HALF_WIDTH: float = 5.0   # |x| inside this is in front of / behind the torso
+TORSO_HALF_DEPTH: float = 3.0   # |y| inside this (and z below the shoulders) is inside it
+MIN_HAND_CLEARANCE: float = 1.0  # closer hand/wrist points across arms are flagged (WARN)
+
+# ---------------------------------------------------------------------------
+# Outgoing-script precheck (precheck.py, run by motion_io before sending)
+# ---------------------------------------------------------------------------
+
+# Per-channel travel in script units (servo degrees; shoulder degrees from the
+# power-on pose, as SHOULDER_HOME_SERVO_DEG describes), mirroring
+# servoMinDeg / servoMaxDeg and the rotation/elevation limits in arm_traits.h.
+# Same wire order as CHANNEL_MAX_SPEED_DEG_PER_SEC.
+CHANNEL_MIN_DEG: list[float] = [0.0] * 5 + [10.0] * 2 + [20.0] + [-45.0, -30.0]
+CHANNEL_MAX_DEG: list[float] = [180.0] * 5 + [170.0] * 2 + [160.0] + [45.0, 90.0]
+
+PRECHECK_RATE_HZ: int = 20  # samples per second along the keyframe path for the collision check
+
 # ---------------------------------------------------------------------------
 # Visualization defaults
 # ---------------------------------------------------------------------------
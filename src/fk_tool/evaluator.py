@@ -8,31 +8,38 @@ structured SignEvaluation results with errors, warnings, and summary metrics.
 from __future__ import annotations
 
 import math
+from concurrent.futures import ProcessPoolExecutor
 
 import numpy as np
 
 from . import config
-from .models import ParsedSign, ParsedKeyframe, EvalIssue, SignEvaluation
-from .servo_mapper import servo_degrees_to_radians, servos_to_joint_angles
+from .fk_engine import get_joint_positions_dual_batch
+from .models import ParsedSign, ParsedKeyframe, EvalIssue, SignEvaluation, SignPoses
+from .servo_mapper import keyframes_to_joint_angles, servos_to_joint_angles
 
 
 # ---------------------------------------------------------------------------
 # Public API
 # ---------------------------------------------------------------------------
 
-def evaluate_sign(parsed_sign: ParsedSign) -> SignEvaluation:
+def evaluate_sign(parsed_sign: ParsedSign, poses: SignPoses | None = None) -> SignEvaluation:
     """Run all evaluation checks on a parsed sign.
 
     Args:
         parsed_sign: A fully-parsed sign with resolved keyframes.
+        poses: The sign's precomputed poses (see compute_sign_poses), or
+               None to compute them here.
 
     Returns:
         A SignEvaluation with all issues and summary metrics.
     """
+    if poses is None:
+        poses = compute_sign_poses([parsed_sign])[0]
+
     issues: list[EvalIssue] = []
 
     issues.extend(check_servo_range(parsed_sign))
-    issues.extend(check_joint_limits(parsed_sign))
+    issues.extend(check_joint_limits(parsed_sign, poses))
     issues.extend(check_timing(parsed_sign))
     issues.extend(check_angular_velocity(parsed_sign))
     issues.extend(check_duration(parsed_sign))
@@ -54,27 +61,90 @@ def evaluate_sign(parsed_sign: ParsedSign) -> SignEvaluation:
     )
 
 
-def evaluate_batch(signs: list[ParsedSign]) -> list[SignEvaluation]:
+def evaluate_batch(signs: list[ParsedSign], workers: int = 1) -> list[SignEvaluation]:
     """Evaluate a list of parsed signs, printing progress.
 
+    The signs are split into chunks. Each chunk gets one vectorized FK pass
+    over all of its keyframes, then the per-sign checks. With workers > 1
+    the chunks run in that many worker processes.
+
     Args:
         signs: List of ParsedSign objects.
+        workers: Number of worker processes; 1 evaluates in this process.
 
     Returns:
-        List of SignEvaluation results.
+        List of SignEvaluation results, in the order of signs.
     """
-    evaluations: list[SignEvaluation] = []
     total = len(signs)
 
-    for index, sign in enumerate(signs):
-        evaluation = evaluate_sign(sign)
+    if workers <= 1 or total < 2:
+        evaluations = _evaluate_chunk(signs)
+    else:
+        # A few chunks per worker so one slow chunk does not hold up the rest
+        chunk_size = max(1, math.ceil(total / (workers * 4)))
+        chunks = [signs[start:start + chunk_size] for start in range(0, total, chunk_size)]
+        with ProcessPoolExecutor(max_workers=workers) as executor:
+            evaluations = [
+                evaluation
+                for chunk_evaluations in executor.map(_evaluate_chunk, chunks)
+                for evaluation in chunk_evaluations
+            ]
+
+    for index, evaluation in enumerate(evaluations):
         status = "PASS" if evaluation.passed else "FAIL"
-        print(f"  [{index + 1}/{total}] {sign.token}: {status}")
-        evaluations.append(evaluation)
+        print(f"  [{index + 1}/{total}] {evaluation.token}: {status}")
 
     return evaluations
 
 
+def _evaluate_chunk(signs: list[ParsedSign]) -> list[SignEvaluation]:
+    """Evaluate signs sharing one batched FK pass (worker process entry point).
+
+    Args:
+        signs: List of ParsedSign objects.
+
+    Returns:
+        List of SignEvaluation results.
+    """
+    all_poses = compute_sign_poses(signs)
+    return [evaluate_sign(sign, poses) for sign, poses in zip(signs, all_poses)]
+
+
+def compute_sign_poses(signs: list[ParsedSign]) -> list[SignPoses]:
+    """Compute joint angles and FK positions for every keyframe of many signs.
+
+    All keyframes of all signs are stacked into one array per arm, converted
+    with the servo_mapper calibration and run through the batch FK engine in
+    a single pass, then split back per sign.
+
+    Args:
+        signs: List of ParsedSign objects.
+
+    Returns:
+        One SignPoses per sign, in the same order.
+    """
+    keyframes = [keyframe for sign in signs for keyframe in sign.keyframes]
+    left_angles, left_present = keyframes_to_joint_angles(keyframes, "left")
+    right_angles, right_present = keyframes_to_joint_angles(keyframes, "right")
+    left_positions, right_positions = get_joint_positions_dual_batch(left_angles, right_angles)
+
+    all_poses: list[SignPoses] = []
+    start = 0
+    for sign in signs:
+        end = start + len(sign.keyframes)
+        all_poses.append(SignPoses(
+            left_joint_angles=left_angles[start:end],
+            right_joint_angles=right_angles[start:end],
+            left_present=left_present[start:end],
+            right_present=right_present[start:end],
+            left_positions=left_positions[start:end],
+            right_positions=right_positions[start:end],
+        ))
+        start = end
+
+    return all_poses
+
+
 # ---------------------------------------------------------------------------
 # Individual checks
 # ---------------------------------------------------------------------------
@@ -160,74 +230,72 @@ def _check_finger_range(
             ))
 
 
-def check_joint_limits(parsed_sign: ParsedSign) -> list[EvalIssue]:
+def check_joint_limits(parsed_sign: ParsedSign, poses: SignPoses | None = None) -> list[EvalIssue]:
     """Check that joint angles (converted from servos) are within calibrated limits.
 
     Args:
         parsed_sign: The sign to check.
+        poses: The sign's precomputed poses, or None to compute them here.
 
     Returns:
         List of FAIL-level issues for joints exceeding mechanical limits.
     """
-    issues: list[EvalIssue] = []
-
-    for kf_index, keyframe in enumerate(parsed_sign.keyframes):
-        _check_arm_joint_limits(keyframe.left_servos, "left", kf_index, issues)
-        _check_arm_joint_limits(keyframe.right_servos, "right", kf_index, issues)
+    if poses is None:
+        poses = compute_sign_poses([parsed_sign])[0]
 
-    return issues
+    violations: list[tuple[int, int, int, bool]] = []
+    arms = [
+        ("left", poses.left_joint_angles, poses.left_present),
+        ("right", poses.right_joint_angles, poses.right_present),
+    ]
 
+    for side_index, (side, joint_angles, present) in enumerate(arms):
+        calibration = config.joint_calibration_for_side(side)
+        min_rad = np.array([calibration[name].min_rad for name in config.JOINT_NAMES])
+        max_rad = np.array([calibration[name].max_rad for name in config.JOINT_NAMES])
+        below = present & (joint_angles < min_rad)
+        above = present & ~below & (joint_angles > max_rad)
+        for kf_index, joint_index in zip(*np.nonzero(below | above)):
+            violations.append((int(kf_index), side_index, int(joint_index), bool(below[kf_index, joint_index])))
 
-def _check_arm_joint_limits(
-    servo_groups: dict[str, list[float]],
-    side: str,
-    keyframe_index: int,
-    issues: list[EvalIssue],
-) -> None:
-    """Check joint limits for one arm's servo groups.
+    # Report per keyframe, left arm before right, joints in chain order
+    violations.sort()
 
-    Args:
-        servo_groups: Servo groups for one arm.
-        side: "left" or "right".
-        keyframe_index: Index of the keyframe being checked.
-        issues: List to append issues to.
-    """
-    group_keys = config.LEFT_ARM_GROUPS if side == "left" else config.RIGHT_ARM_GROUPS
+    issues: list[EvalIssue] = []
+    for kf_index, side_index, joint_index, is_below in violations:
+        side, joint_angles, _present = arms[side_index]
+        joint_name = config.JOINT_NAMES[joint_index]
+        joint_rad = float(joint_angles[kf_index, joint_index])
+        calibration = config.joint_calibration_for_side(side)[joint_name]
 
-    for group_key in group_keys:
-        if group_key not in servo_groups:
-            continue
-        for joint_name, servo_index in config.SERVO_GROUP_TO_JOINTS[group_key]:
-            servo_value = servo_groups[group_key][servo_index]
-            joint_rad = servo_degrees_to_radians(servo_value, joint_name, side)
-            calibration = config.joint_calibration_for_side(side)[joint_name]
+        if is_below:
+            issues.append(EvalIssue(
+                level="FAIL",
+                metric="joint_limit_violation",
+                message=(
+                    f"{side} {joint_name} = {math.degrees(joint_rad):.1f} deg "
+                    f"< min {math.degrees(calibration.min_rad):.1f} deg"
+                ),
+                keyframe_index=kf_index,
+                joint_name=joint_name,
+                value=joint_rad,
+                limit=calibration.min_rad,
+            ))
+        else:
+            issues.append(EvalIssue(
+                level="FAIL",
+                metric="joint_limit_violation",
+                message=(
+                    f"{side} {joint_name} = {math.degrees(joint_rad):.1f} deg "
+                    f"> max {math.degrees(calibration.max_rad):.1f} deg"
+                ),
+                keyframe_index=kf_index,
+                joint_name=joint_name,
+                value=joint_rad,
+                limit=calibration.max_rad,
+            ))
 
-            if joint_rad < calibration.min_rad:
-                issues.append(EvalIssue(
-                    level="FAIL",
-                    metric="joint_limit_violation",
-                    message=(
-                        f"{side} {joint_name} = {math.degrees(joint_rad):.1f} deg "
-                        f"< min {math.degrees(calibration.min_rad):.1f} deg"
-                    ),
-                    keyframe_index=keyframe_index,
-                    joint_name=joint_name,
-                    value=joint_rad,
-                    limit=calibration.min_rad,
-                ))
-            elif joint_rad > calibration.max_rad:
-                issues.append(EvalIssue(
-                    level="FAIL",
-                    metric="joint_limit_violation",
-                    message=(
-                        f"{side} {joint_name} = {math.degrees(joint_rad):.1f} deg "
-                        f"> max {math.degrees(calibration.max_rad):.1f} deg"
-                    ),
-                    keyframe_index=keyframe_index,
-                    joint_name=joint_name,
-                    value=joint_rad,
-                    limit=calibration.max_rad,
-                ))
+    return issues
 
 
 def check_timing(parsed_sign: ParsedSign) -> list[EvalIssue]:
@@ -251,3 +251,127 @@ def get_joint_positions_dual(
     right_positions[:, 0] += config.SHOULDER_X_OFFSET
 
     return left_positions, right_positions
+
+
+# ---------------------------------------------------------------------------
+# Batch API — many poses in one vectorized pass
+# ---------------------------------------------------------------------------
+
+def _rotation_batch(axis: str, angles_rad: np.ndarray) -> np.ndarray:
+    """Build N 4x4 homogeneous rotation matrices about one axis.
+
+    Args:
+        axis: "x", "y", or "z".
+        angles_rad: Array of N rotation angles in radians.
+
+    Returns:
+        Nx4x4 numpy array, entry-for-entry equal to _rotation_<axis>.
+    """
+    cos_a = np.cos(angles_rad)
+    sin_a = np.sin(angles_rad)
+    rotations = np.zeros((len(angles_rad), 4, 4))
+    rotations[:, 3, 3] = 1.0
+    if axis == "x":
+        rotations[:, 0, 0] = 1.0
+        rotations[:, 1, 1] = cos_a
+        rotations[:, 1, 2] = -sin_a
+        rotations[:, 2, 1] = sin_a
+        rotations[:, 2, 2] = cos_a
+    elif axis == "y":
+        rotations[:, 0, 0] = cos_a
+        rotations[:, 0, 2] = sin_a
+        rotations[:, 1, 1] = 1.0
+        rotations[:, 2, 0] = -sin_a
+        rotations[:, 2, 2] = cos_a
+    else:
+        rotations[:, 0, 0] = cos_a
+        rotations[:, 0, 1] = -sin_a
+        rotations[:, 1, 0] = sin_a
+        rotations[:, 1, 1] = cos_a
+        rotations[:, 2, 2] = 1.0
+    return rotations
+
+
+def _batch_local_transforms(joint_angles: np.ndarray) -> list[np.ndarray]:
+    """Build T01..T45 for N poses at once (the batch form of _TRANSFORM_BUILDERS).
+
+    Args:
+        joint_angles: Nx5 array of joint angles in radians.
+
+    Returns:
+        List of 5 Nx4x4 arrays, one per joint.
+    """
+    shoulder_swing = _rotation_batch("x", joint_angles[:, 0])
+    shoulder_abduction = _rotation_batch("y", joint_angles[:, 1])
+    shoulder_abduction[:, 0, 3] = config.SHOULDER_OFFSET_LENGTH
+    elbow_flexion = _rotation_batch("x", joint_angles[:, 2])
+    elbow_flexion[:, 2, 3] = -config.UPPER_ARM_LENGTH
+    wrist_flexion = _rotation_batch("x", joint_angles[:, 3])
+    wrist_flexion[:, 2, 3] = -config.FOREARM_LENGTH
+    wrist_pronation = _rotation_batch("z", joint_angles[:, 4])
+    wrist_pronation[:, 2, 3] = -config.WRIST_LENGTH
+    return [shoulder_swing, shoulder_abduction, elbow_flexion, wrist_flexion, wrist_pronation]
+
+
+def compute_transforms_batch(joint_angles: np.ndarray) -> np.ndarray:
+    """Compute cumulative world-frame transforms for N poses at once.
+
+    Same chain as compute_transforms, but every pose advances one joint per
+    matrix product, so the cost is five batched products regardless of N.
+
+    Args:
+        joint_angles: Nx5 array of joint angles in radians, one pose per row.
+
+    Returns:
+        Nx6x4x4 array; [i] is compute_transforms(joint_angles[i]) stacked.
+    """
+    joint_angles = np.asarray(joint_angles, dtype=float).reshape(-1, config.NUM_JOINTS)
+    pose_count = len(joint_angles)
+
+    cumulative_transforms = np.empty((pose_count, config.NUM_JOINTS + 1, 4, 4))
+    cumulative_transforms[:, 0] = np.eye(4)
+
+    for index, local_transforms in enumerate(_batch_local_transforms(joint_angles)):
+        cumulative_transforms[:, index + 1] = cumulative_transforms[:, index] @ local_transforms
+
+    return cumulative_transforms
+
+
+def get_joint_positions_batch(joint_angles: np.ndarray) -> np.ndarray:
+    """Compute 3D joint positions for N poses at once.
+
+    Args:
+        joint_angles: Nx5 array of joint angles in radians.
+
+    Returns:
+        Nx6x3 array; [i] is get_joint_positions(joint_angles[i]).
+    """
+    return compute_transforms_batch(joint_angles)[:, :, 0:3, 3]
+
+
+def get_joint_positions_dual_batch(
+    left_joint_angles: np.ndarray,
+    right_joint_angles: np.ndarray,
+    mirror_left: bool = True,
+) -> tuple[np.ndarray, np.ndarray]:
+    """Batch form of get_joint_positions_dual.
+
+    Args:
+        left_joint_angles: Nx5 array of left arm joint angles (radians).
+        right_joint_angles: Mx5 array of right arm joint angles (radians).
+        mirror_left: If True, negate q2 for the left arm so it mirrors correctly.
+
+    Returns:
+        Tuple of (left_positions, right_positions), Nx6x3 and Mx6x3 arrays.
+    """
+    left_angles_adjusted = np.array(left_joint_angles, dtype=float).reshape(-1, config.NUM_JOINTS)
+    if mirror_left:
+        left_angles_adjusted[:, 1] = -left_angles_adjusted[:, 1]
+
+    left_positions = get_joint_positions_batch(left_angles_adjusted)
+    left_positions[:, :, 0] = -left_positions[:, :, 0] - config.SHOULDER_X_OFFSET
+
+    right_positions = get_joint_positions_batch(right_joint_angles)
+    right_positions[:, :, 0] += config.SHOULDER_X_OFFSET
+
+    return left_positions, right_positions
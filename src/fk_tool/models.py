@@ -8,6 +8,8 @@ from __future__ import annotations
 
 from dataclasses import dataclass, field
 
+import numpy as np
+
 
 @dataclass
 class ParsedKeyframe:
@@ -49,6 +51,26 @@ class ParsedSign:
     raw: dict = field(default_factory=dict)
 
 
+@dataclass
+class SignPoses:
+    """Joint angles and FK joint positions for every keyframe of one sign.
+
+    Attributes:
+        left_joint_angles: Kx5 left arm joint angles in radians.
+        right_joint_angles: Kx5 right arm joint angles in radians.
+        left_present: Kx5 bool mask of left joints the keyframes define.
+        right_present: Kx5 bool mask of right joints the keyframes define.
+        left_positions: Kx6x3 left arm joint positions (body frame, inches).
+        right_positions: Kx6x3 right arm joint positions (body frame, inches).
+    """
+    left_joint_angles: np.ndarray
+    right_joint_angles: np.ndarray
+    left_present: np.ndarray
+    right_present: np.ndarray
+    left_positions: np.ndarray
+    right_positions: np.ndarray
+
+
 # ---------------------------------------------------------------------------
 # Evaluation models
 # ---------------------------------------------------------------------------
@@ -93,3 +115,54 @@ class SignEvaluation:
     warnings: list[EvalIssue] = field(default_factory=list)
     info: list[EvalIssue] = field(default_factory=list)
     metrics: dict[str, float] = field(default_factory=dict)
+
+
+# ---------------------------------------------------------------------------
+# Trajectory compiler models
+# ---------------------------------------------------------------------------
+
+@dataclass
+class CompiledTrajectory:
+    """A sign compiled to fixed-rate setpoints, one array per arm it drives.
+
+    Attributes:
+        token: The sign's name/identifier.
+        rate_hz: Samples per second.
+        duration: Seconds the firmware plays the sign for (at least the last sample).
+        times: N sample times in seconds, 0.0 first.
+        samples: Per side ("left"/"right"), an Nx10 array in wire channel order:
+                 hand (5), wrist (2), elbow (1) in servo degrees, shoulder (2) in degrees.
+        driven: Per side, a 10-element bool mask of the channels the sign sets.
+        issues: Collision findings from the FK check of every sample.
+    """
+    token: str
+    rate_hz: int
+    duration: float
+    times: np.ndarray
+    samples: dict[str, np.ndarray] = field(default_factory=dict)
+    driven: dict[str, np.ndarray] = field(default_factory=dict)
+    issues: list[EvalIssue] = field(default_factory=list)
+
+    @property
+    def passed(self) -> bool:
+        """True if no FAIL-level collision issues were found."""
+        return not any(issue.level == "FAIL" for issue in self.issues)
+
+
+@dataclass
+class SafetyVerdict:
+    """Whether a script is safe to send to the controllers (see precheck.py).
+
+    Attributes:
+        token: The sign's name/identifier.
+        passed: True if no FAIL-level issues were found.
+        issues: Channel-limit and collision findings.
+    """
+    token: str
+    passed: bool
+    issues: list[EvalIssue] = field(default_factory=list)
+
+    @property
+    def reason(self) -> str:
+        """The first FAIL message, or "" for a passing verdict."""
+        return next((issue.message for issue in self.issues if issue.level == "FAIL"), "")
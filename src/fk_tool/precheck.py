@@ -0,0 +1,139 @@
+"""
+Safety precheck for outgoing motion scripts.
+
+motion_io runs every script through precheck_script once per script version
+(see src/cache/verdict_cache.py) and logs a failing one; it refuses to send it
+only with PRECHECK_REFUSES, off while the limits are placeholders. A script
+fails when a channel it drives leaves the controllers' travel limits
+(CHANNEL_MIN_DEG / CHANNEL_MAX_DEG, the same tables the firmware clamps to)
+or when the FK geometry puts an arm inside the torso anywhere along the
+keyframe path. Both checks read channels the way the trajectory compiler
+does: shoulders in degrees from the power-on pose, unset channels at the
+rest pose (keyframe_channels, channels_to_joint_angles). The evaluator's joint-limit check is not used here: its
+calibration limits are still unconfirmed, so it would hold back signs the
+robot plays fine.
+"""
+
+from __future__ import annotations
+
+import numpy as np
+
+from . import config
+from .models import EvalIssue, ParsedSign, SafetyVerdict
+from .sign_parser import parse_sign
+from .trajectory import (
+    CHANNEL_GROUPS,
+    NUM_CHANNELS,
+    check_self_collision,
+    driven_channels,
+    keyframe_channels,
+)
+
+
+# Channel names for issue messages, by wire column
+_CHANNEL_NAMES: list[str] = [
+    f"{suffix or 'H'}[{index}]" for suffix, _first, width in CHANNEL_GROUPS for index in range(width)
+]
+
+
+# ---------------------------------------------------------------------------
+# Public API
+# ---------------------------------------------------------------------------
+
+def precheck_script(raw_sign: dict) -> SafetyVerdict:
+    """Check one motion script against the channel limits and the torso.
+
+    Args:
+        raw_sign: The script as motion_io sends it (token, keyframes, ...).
+
+    Returns:
+        A SafetyVerdict; passed is False if any FAIL-level issue was found.
+    """
+    token = str(raw_sign.get("token", ""))
+    try:
+        parsed_sign = parse_sign(raw_sign)
+        issues = check_channel_limits(parsed_sign)
+        issues.extend(check_keyframe_path(parsed_sign))
+    except (ValueError, TypeError, KeyError) as e:
+        issues = [EvalIssue(level="FAIL", metric="unreadable_script", message=f"Cannot check script: {e}")]
+
+    return SafetyVerdict(
+        token=token,
+        passed=not any(issue.level == "FAIL" for issue in issues),
+        issues=issues,
+    )
+
+
+# ---------------------------------------------------------------------------
+# Individual checks
+# ---------------------------------------------------------------------------
+
+def _sides(parsed_sign: ParsedSign) -> list[str]:
+    return ["left", "right"] if parsed_sign.arm == "both" else [parsed_sign.arm]
+
+
+def check_channel_limits(parsed_sign: ParsedSign) -> list[EvalIssue]:
+    """Check every driven channel of every keyframe against its travel limits.
+
+    Args:
+        parsed_sign: The sign to check.
+
+    Returns:
+        List of FAIL-level "channel_limit" issues, one per channel and arm
+        (at its first offending keyframe).
+    """
+    min_deg = np.array(config.CHANNEL_MIN_DEG)
+    max_deg = np.array(config.CHANNEL_MAX_DEG)
+    issues: list[EvalIssue] = []
+
+    for side in _sides(parsed_sign):
+        rows = keyframe_channels(parsed_sign, side)
+        driven = driven_channels(parsed_sign, side)
+        outside = ((rows < min_deg) | (rows > max_deg)) & driven
+        for column in np.nonzero(outside.any(axis=0))[0]:
+            kf_index = int(np.argmax(outside[:, column]))
+            value = float(rows[kf_index, column])
+            limit = config.CHANNEL_MIN_DEG[column] if value < min_deg[column] else config.CHANNEL_MAX_DEG[column]
+            issues.append(EvalIssue(
+                level="FAIL",
+                metric="channel_limit",
+                message=(
+                    f"{side} {_CHANNEL_NAMES[column]} = {value:.1f} is outside "
+                    f"[{min_deg[column]:.0f}, {max_deg[column]:.0f}]"
+                ),
+                keyframe_index=kf_index,
+                joint_name=f"{side}_{_CHANNEL_NAMES[column]}",
+                value=value,
+                limit=limit,
+            ))
+
+    return issues
+
+
+def check_keyframe_path(parsed_sign: ParsedSign, rate_hz: int = config.PRECHECK_RATE_HZ) -> list[EvalIssue]:
+    """Run the self-collision check along the interpolated keyframe path.
+
+    Samples every keyframe plus rate_hz points per second between them, the
+    straight-line path timed playback follows.
+
+    Args:
+        parsed_sign: The sign to check.
+        rate_hz: Samples per second between keyframes.
+
+    Returns:
+        The "self_collision" / "arm_proximity" issues of check_self_collision.
+    """
+    if not parsed_sign.keyframes:
+        return []
+
+    key_times = np.array([keyframe.time for keyframe in parsed_sign.keyframes], dtype=float)
+    times = np.union1d(np.arange(0.0, key_times[-1], 1.0 / rate_hz), key_times)
+
+    samples = {}
+    for side in ("left", "right"):
+        rows = keyframe_channels(parsed_sign, side)
+        samples[side] = np.column_stack([
+            np.interp(times, key_times, rows[:, column]) for column in range(NUM_CHANNELS)
+        ])
+
+    return check_self_collision(samples["left"], samples["right"], times, _sides(parsed_sign))
@@ -122,3 +122,63 @@ def joint_angles_to_servos(
         servo_groups[group_key] = servo_values
 
     return servo_groups
+
+
+def keyframes_to_joint_angles(
+    keyframes: list,
+    side: str,
+) -> tuple[np.ndarray, np.ndarray]:
+    """Convert many keyframes' servo groups to joint angles in one pass.
+
+    Batch form of servos_to_joint_angles: servo values are gathered into an
+    Nx5 array and the calibration is applied to whole columns.
+
+    Args:
+        keyframes: ParsedKeyframe list (possibly from several signs).
+        side: "left" or "right".
+
+    Returns:
+        Tuple of (joint_angles, present). joint_angles is Nx5 in radians,
+        with 0.0 where the keyframe has no value for a joint (as in
+        servos_to_joint_angles); present is the matching Nx5 bool mask.
+    """
+    if side == "left":
+        group_keys = config.LEFT_ARM_GROUPS
+    elif side == "right":
+        group_keys = config.RIGHT_ARM_GROUPS
+    else:
+        raise ValueError(f"side must be 'left' or 'right', got '{side}'")
+
+    servo_values = np.zeros((len(keyframes), config.NUM_JOINTS))
+    present = np.zeros((len(keyframes), config.NUM_JOINTS), dtype=bool)
+    servos_attr = "left_servos" if side == "left" else "right_servos"
+
+    for kf_index, keyframe in enumerate(keyframes):
+        servo_groups = getattr(keyframe, servos_attr)
+        for group_key in group_keys:
+            if group_key not in servo_groups:
+                continue
+            for joint_name, servo_index in config.SERVO_GROUP_TO_JOINTS[group_key]:
+                joint_index = config.JOINT_NAMES.index(joint_name)
+                servo_values[kf_index, joint_index] = servo_groups[group_key][servo_index]
+                present[kf_index, joint_index] = True
+
+    joint_angles = servo_array_to_joint_angles(servo_values, side)
+    joint_angles[~present] = 0.0
+    return joint_angles, present
+
+
+def servo_array_to_joint_angles(servo_values: np.ndarray, side: str) -> np.ndarray:
+    """Convert an Nx5 array of servo degrees (joint order q1..q5) to radians.
+
+    Args:
+        servo_values: Nx5 servo positions in degrees, columns in JOINT_NAMES order.
+        side: "left" or "right" — selects the calibration.
+
+    Returns:
+        Nx5 array of joint angles in radians.
+    """
+    calibration = config.joint_calibration_for_side(side)
+    neutral = np.array([calibration[name].neutral_servo_deg for name in config.JOINT_NAMES])
+    scale = np.array([calibration[name].scale for name in config.JOINT_NAMES])
+    return (np.asarray(servo_values, dtype=float) - neutral) * scale * (math.pi / 180.0)
@@ -6,6 +6,7 @@ Verifies:
   2. A sign with out-of-range servo (999) fails with servo_range_violation.
   3. A sign with non-monotonic keyframe times fails with timing error.
   4. Batch evaluation of all signs from signs_to_seed.json completes without exceptions.
+  5. Worker-process batch evaluation matches in-process evaluation.
 """
 
 from pathlib import Path
@@ -222,3 +223,26 @@ class TestBatchEvaluation:
         for evaluation in evaluations:
             assert len(evaluation.metrics) > 0
             assert "duration" in evaluation.metrics
+
+
+# ---------------------------------------------------------------------------
+# Test 5: Worker processes give the same results
+# ---------------------------------------------------------------------------
+
+class TestParallelBatchEvaluation:
+    """Evaluating in worker processes should not change any result."""
+
+    def test_workers_match_serial(self) -> None:
+        """evaluate_batch with workers=2 should equal per-sign evaluate_sign."""
+        raw_signs = [_make_valid_sign(), _make_bad_servo_sign(), _make_bad_timing_sign()]
+        parsed_signs = parse_signs(raw_signs)
+
+        parallel = evaluate_batch(parsed_signs, workers=2)
+        serial = [evaluate_sign(sign) for sign in parsed_signs]
+
+        assert [e.token for e in parallel] == [s.token for s in parsed_signs]
+        for parallel_eval, serial_eval in zip(parallel, serial):
+            assert parallel_eval.passed == serial_eval.passed
+            assert parallel_eval.errors == serial_eval.errors
+            assert parallel_eval.warnings == serial_eval.warnings
+            assert parallel_eval.metrics == pytest.approx(serial_eval.metrics)
@@ -0,0 +1,167 @@
+"""
+Tests for the outgoing-script safety precheck.
+
+Verifies:
+  1. The rest poses and fingerspelling letters motion_io sends pass.
+  2. A driven channel outside its travel fails with channel_limit, and an unreadable script fails too.
+  3. An arm swung into the torso fails with self_collision.
+  4. The verdict cache checks each script version once, by content.
+  5. Every seeded sign can be checked, and motion_io still sends it.
+"""
+
+from pathlib import Path
+
+import pytest
+
+from src.cache.fingerspelling_cache import FINGERSPELL_CACHE
+from src.cache.rest_cache import REST_LEFT, REST_RIGHT
+from src.cache.verdict_cache import VerdictCache
+from src.fk_tool.loaders import load_from_json
+from src.fk_tool.precheck import precheck_script
+from src.io import motion_io
+
+
+# ---------------------------------------------------------------------------
+# Helpers — hand-crafted sign dicts
+# ---------------------------------------------------------------------------
+
+def _make_wrist_sign(wrist_value: float) -> dict:
+    """Right-wrist-only sign moving the first wrist servo to wrist_value."""
+    return {
+        "token": "TEST_WRIST",
+        "type": "DYNAMIC",
+        "duration": 1.0,
+        "keyframes": [
+            {"time": 0.0, "RW": [90, 90]},
+            {"time": 1.0, "RW": [wrist_value, 90]},
+        ],
+    }
+
+
+def _make_torso_sign() -> dict:
+    """Right shoulder raised across the body on the way to its last keyframe, inside its travel."""
+    return {
+        "token": "TEST_TORSO",
+        "type": "DYNAMIC",
+        "duration": 1.0,
+        "keyframes": [
+            {"time": 0.0, "RE": [90], "RW": [90, 90], "RS": [0, 0]},
+            {"time": 1.0, "RE": [90], "RW": [90, 90], "RS": [0, 60]},
+        ],
+    }
+
+
+# ---------------------------------------------------------------------------
+# Test 1: The scripts every session plays pass
+# ---------------------------------------------------------------------------
+
+class TestBuiltinScripts:
+    """Rests and letters are sent on every run, so they must never be held back."""
+
+    def test_rests_and_letters_pass(self) -> None:
+        """Every built-in script passes the precheck."""
+        for script in [REST_LEFT, REST_RIGHT] + list(FINGERSPELL_CACHE.values()):
+            verdict = precheck_script(script)
+            assert verdict.passed is True, f"{script['token']}: {verdict.reason}"
+
+
+# ---------------------------------------------------------------------------
+# Test 2: Channel limits
+# ---------------------------------------------------------------------------
+
+class TestChannelLimits:
+    """Driven channels are checked against the firmware's travel tables."""
+
+    def test_wrist_past_limit_fails(self) -> None:
+        """A wrist servo at 178 deg is past its 170 deg stop."""
+        verdict = precheck_script(_make_wrist_sign(178))
+
+        limit_errors = [issue for issue in verdict.issues if issue.metric == "channel_limit"]
+        assert verdict.passed is False
+        assert len(limit_errors) == 1
+        assert limit_errors[0].value == 178.0
+        assert limit_errors[0].keyframe_index == 1
+
+    def test_wrist_inside_limit_passes(self) -> None:
+        """The same sign at 160 deg passes."""
+        assert precheck_script(_make_wrist_sign(160)).passed is True
+
+    def test_malformed_script_fails(self) -> None:
+        """A script without keyframes cannot be checked, so it is not sent."""
+        verdict = precheck_script({"token": "TEST_EMPTY"})
+
+        assert verdict.passed is False
+        assert verdict.issues[0].metric == "unreadable_script"
+
+
+# ---------------------------------------------------------------------------
+# Test 3: Geometry
+# ---------------------------------------------------------------------------
+
+class TestKeyframePath:
+    """The interpolated keyframe path is checked against the torso."""
+
+    def test_torso_contact_fails(self) -> None:
+        """The elbow entering the torso between keyframes is reported as self_collision."""
+        verdict = precheck_script(_make_torso_sign())
+
+        assert verdict.passed is False
+        assert any(issue.metric == "self_collision" for issue in verdict.issues)
+        assert not any(issue.metric == "channel_limit" for issue in verdict.issues)
+
+
+# ---------------------------------------------------------------------------
+# Test 4: Verdict cache
+# ---------------------------------------------------------------------------
+
+class TestVerdictCache:
+    """Verdicts are cached by script content."""
+
+    def test_checks_each_version_once(self) -> None:
+        """Equal scripts share a verdict; an edited one is checked again."""
+        cache = VerdictCache()
+        checked: list[str] = []
+
+        def check(script: dict):
+            checked.append(script["token"])
+            return precheck_script(script)
+
+        first = cache.get(_make_wrist_sign(178), check)
+        again = cache.get(_make_wrist_sign(178), check)
+        edited = cache.get(_make_wrist_sign(160), check)
+
+        assert checked == ["TEST_WRIST", "TEST_WRIST"]
+        assert again is first
+        assert first.passed is False and edited.passed is True
+
+
+# ---------------------------------------------------------------------------
+# Test 5: The seeded library
+# ---------------------------------------------------------------------------
+
+class TestSeededLibrary:
+    """The placeholder limits must not hold back the signs the DB is seeded with."""
+
+    @pytest.fixture()
+    def seeded_signs(self) -> list[dict]:
+        """Every sign in signs_to_seed.json."""
+        path = Path(__file__).resolve().parents[2] / "signs" / "signs_to_seed.json"
+        if not path.exists():
+            pytest.skip(f"Seed file not found at {path}")
+        return load_from_json(str(path))
+
+    def test_seeded_signs_are_checked_and_sent(self, seeded_signs: list[dict]) -> None:
+        """Each seeded sign gets a readable verdict and a plan motion_io sends, pass or fail."""
+        for sign in seeded_signs:
+            verdict = precheck_script(sign)
+            assert not any(issue.metric == "unreadable_script" for issue in verdict.issues), (
+                f"{sign['token']}: {verdict.reason}"
+            )
+            assert motion_io.compile_plan(sign)["rejected"] is None, sign["token"]
+
+    def test_refusing_skips_failing_scripts(self, monkeypatch) -> None:
+        """With PRECHECK_REFUSES set, a failing script's plan carries the reason."""
+        monkeypatch.setattr(motion_io, "PRECHECK_REFUSES", True)
+        plan = motion_io.compile_plan(_make_wrist_sign(178))
+
+        assert "outside" in plan["rejected"]
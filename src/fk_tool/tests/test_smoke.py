@@ -5,6 +5,7 @@ Verifies:
   1. All-zero joint angles produce an arm hanging straight down (-Z axis).
   2. Loading and parsing every sign from signs_to_seed.json succeeds with zero crashes.
   3. Servo [90,90,90,90,90] maps to all-zero joint angles.
+  4. Batch FK and batch servo mapping match the per-pose functions.
 """
 
 import math
@@ -14,8 +15,18 @@ import numpy as np
 import pytest
 
 from src.fk_tool import config
-from src.fk_tool.fk_engine import get_joint_positions, compute_transforms
-from src.fk_tool.servo_mapper import servos_to_joint_angles, joint_angles_to_servos
+from src.fk_tool.fk_engine import (
+    get_joint_positions,
+    compute_transforms,
+    compute_transforms_batch,
+    get_joint_positions_dual,
+    get_joint_positions_dual_batch,
+)
+from src.fk_tool.servo_mapper import (
+    servos_to_joint_angles,
+    joint_angles_to_servos,
+    keyframes_to_joint_angles,
+)
 from src.fk_tool.loaders import load_from_json
 from src.fk_tool.sign_parser import parse_sign, parse_signs
 
@@ -167,3 +178,50 @@ class TestNeutralServoMapping:
         recovered_angles = servos_to_joint_angles(servos, side="left")
 
         np.testing.assert_allclose(recovered_angles, original_angles, atol=1e-6)
+
+
+# ---------------------------------------------------------------------------
+# Test 4: Batch FK matches the per-pose chain
+# ---------------------------------------------------------------------------
+
+class TestBatchFK:
+    """The vectorized engine should reproduce the per-pose results exactly."""
+
+    def test_batch_transforms_match_single(self) -> None:
+        """compute_transforms_batch[i] should equal compute_transforms(angles[i])."""
+        rng = np.random.default_rng(0)
+        angles = rng.uniform(-math.pi, math.pi, size=(20, config.NUM_JOINTS))
+        batch = compute_transforms_batch(angles)
+
+        assert batch.shape == (20, config.NUM_JOINTS + 1, 4, 4)
+        for pose_angles, pose_transforms in zip(angles, batch):
+            np.testing.assert_allclose(
+                pose_transforms, np.array(compute_transforms(pose_angles)), atol=1e-12,
+            )
+
+    def test_batch_dual_positions_match_single(self) -> None:
+        """Both arms' batch positions should equal get_joint_positions_dual."""
+        rng = np.random.default_rng(1)
+        left = rng.uniform(-1.0, 1.0, size=(5, config.NUM_JOINTS))
+        right = rng.uniform(-1.0, 1.0, size=(5, config.NUM_JOINTS))
+        left_batch, right_batch = get_joint_positions_dual_batch(left, right)
+
+        for i in range(5):
+            left_single, right_single = get_joint_positions_dual(left[i], right[i])
+            np.testing.assert_allclose(left_batch[i], left_single, atol=1e-12)
+            np.testing.assert_allclose(right_batch[i], right_single, atol=1e-12)
+
+    def test_batch_servo_mapping_matches_single(self) -> None:
+        """keyframes_to_joint_angles rows should equal servos_to_joint_angles."""
+        path = Path(__file__).resolve().parents[2] / "signs" / "signs_to_seed.json"
+        if not path.exists():
+            pytest.skip(f"Seed file not found at {path}")
+        keyframes = [kf for sign in parse_signs(load_from_json(str(path))) for kf in sign.keyframes]
+
+        for side, servos_attr in [("left", "left_servos"), ("right", "right_servos")]:
+            joint_angles, present = keyframes_to_joint_angles(keyframes, side)
+            assert present.all()
+            for keyframe, row in zip(keyframes, joint_angles):
+                np.testing.assert_array_equal(
+                    row, servos_to_joint_angles(getattr(keyframe, servos_attr), side),
+                )
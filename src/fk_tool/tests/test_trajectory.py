@@ -0,0 +1,155 @@
+"""
+Tests for the offline trajectory compiler.
+
+Verifies:
+  1. Compiled samples never move a channel faster than its speed limit, and land on the target;
+     channels a sign leaves unset hold the rest pose.
+  2. A compiled sign round-trips through the .traj container with its script digest.
+  3. An elbow swung into the torso fails the collision check; a neutral pose does not.
+"""
+
+import numpy as np
+
+from src.fk_tool import config
+from src.fk_tool.sign_parser import parse_sign
+from src.fk_tool.trajectory import compile_sign, encode_trajectory, keyframe_channels
+from src.io.motion_frames import (
+    FRAME_FLAG_SAMPLED,
+    FRAME_TYPE_STREAM_BEGIN,
+    script_digest,
+    stream_duration,
+    unpack_trajectory,
+)
+
+
+# ---------------------------------------------------------------------------
+# Helpers — hand-crafted sign dicts
+# ---------------------------------------------------------------------------
+
+def _make_fast_right_sign() -> dict:
+    """Right-arm sign whose elbow and fingers jump further than they can move in time."""
+    return {
+        "token": "TEST_FAST",
+        "type": "DYNAMIC",
+        "duration": 0.5,
+        "keyframes": [
+            {"time": 0.0, "RE": [30], "RW": [90, 90], "R": [0, 0, 0, 0, 0]},
+            {"time": 0.1, "RE": [150], "RW": [90, 90], "R": [180, 180, 180, 180, 180]},
+        ],
+    }
+
+
+def _make_torso_collision_sign() -> dict:
+    """Right shoulder raised 60 deg across the body (inside its travel), putting the elbow in the torso."""
+    return {
+        "token": "TEST_TORSO",
+        "type": "STATIC",
+        "duration": 1.0,
+        "keyframes": [
+            {"time": 0.0, "RS": [0, 60], "RE": [90], "RW": [90, 90]},
+            {"time": 1.0, "RS": [0, 60], "RE": [90], "RW": [90, 90]},
+        ],
+    }
+
+
+def _make_neutral_sign() -> dict:
+    """Both arms held at the rest pose (shoulders at their power-on position)."""
+    pose = {"LS": [0, 0], "LE": [90], "LW": [90, 90], "RS": [0, 0], "RE": [90], "RW": [90, 90]}
+    return {
+        "token": "TEST_NEUTRAL",
+        "type": "STATIC",
+        "duration": 1.0,
+        "keyframes": [dict(pose, time=0.0), dict(pose, time=1.0)],
+    }
+
+
+# ---------------------------------------------------------------------------
+# Test 1: Rate limits
+# ---------------------------------------------------------------------------
+
+class TestRateLimits:
+    """Samples follow the firmware's per-channel speed limits."""
+
+    def test_samples_respect_speed_limits(self) -> None:
+        """No channel moves more than its max speed per sample, and each ends on its target."""
+        compiled = compile_sign(parse_sign(_make_fast_right_sign()), rate_hz=100)
+        samples = compiled.samples["right"]
+
+        step_limit = np.array(config.CHANNEL_MAX_SPEED_DEG_PER_SEC) / compiled.rate_hz
+        steps = np.abs(np.diff(samples, axis=0))
+        assert np.all(steps <= step_limit + 1e-9)
+
+        # The jumps take longer than the 0.1s between keyframes, so samples run on
+        assert len(compiled.times) > 11
+        assert samples[-1, 7] == 150.0
+        assert np.all(samples[-1, 0:5] == 180.0)
+        assert compiled.duration >= compiled.times[-1]
+
+    def test_only_driven_channels_are_marked(self) -> None:
+        """A right-arm sign drives hand, wrist and elbow but not the shoulder."""
+        compiled = compile_sign(parse_sign(_make_fast_right_sign()))
+
+        assert list(compiled.samples) == ["right"]
+        assert compiled.driven["right"].tolist() == [True] * 8 + [False] * 2
+
+    def test_unset_channels_hold_rest_pose(self) -> None:
+        """Channels the sign never sets hold the rest pose, shoulders at 0 deg, not the parser's 90."""
+        parsed = parse_sign(_make_fast_right_sign())
+
+        assert keyframe_channels(parsed, "right")[:, 8:10].tolist() == [[0.0, 0.0], [0.0, 0.0]]
+        assert keyframe_channels(parsed, "left").tolist() == [config.CHANNEL_REST_POSE] * 2
+
+
+# ---------------------------------------------------------------------------
+# Test 2: .traj container
+# ---------------------------------------------------------------------------
+
+class TestTrajectoryEncoding:
+    """A compiled sign packs into sampled stream frames and unpacks unchanged."""
+
+    def test_round_trip(self) -> None:
+        """unpack_trajectory returns the digest, rate and one sampled stream per arm."""
+        raw = _make_fast_right_sign()
+        compiled = compile_sign(parse_sign(raw), rate_hz=50)
+        digest, rate_hz, frames_by_side = unpack_trajectory(encode_trajectory(compiled, raw))
+
+        assert digest == script_digest(raw)
+        assert rate_hz == 50
+        assert list(frames_by_side) == ["right"]
+
+        header = frames_by_side["right"][0]
+        assert header[3] == FRAME_TYPE_STREAM_BEGIN
+        assert header[5] & FRAME_FLAG_SAMPLED
+        assert abs(stream_duration(header) - compiled.duration) < 1e-3
+
+    def test_digest_changes_with_script(self) -> None:
+        """Editing a keyframe changes the digest a stale .traj is detected by."""
+        raw = _make_fast_right_sign()
+        edited = _make_fast_right_sign()
+        edited["keyframes"][1]["RE"] = [140]
+
+        assert script_digest(raw) != script_digest(edited)
+
+
+# ---------------------------------------------------------------------------
+# Test 3: Self-collision
+# ---------------------------------------------------------------------------
+
+class TestSelfCollision:
+    """Every sample is checked against the torso box."""
+
+    def test_elbow_in_torso_fails(self) -> None:
+        """The abducted right arm is reported as a FAIL-level self_collision."""
+        compiled = compile_sign(parse_sign(_make_torso_collision_sign()))
+
+        collisions = [issue for issue in compiled.issues if issue.metric == "self_collision"]
+        assert compiled.passed is False
+        assert collisions and collisions[0].level == "FAIL"
+        assert collisions[0].joint_name == "right_elbow"
+
+    def test_neutral_pose_passes(self) -> None:
+        """Arms hanging at the rest pose collide with nothing."""
+        compiled = compile_sign(parse_sign(_make_neutral_sign()))
+
+        assert compiled.passed is True
+        assert not [issue for issue in compiled.issues if issue.metric == "self_collision"]
@@ -0,0 +1,365 @@
+"""
+Offline trajectory compiler.
+
+Turns a sign's keyframes into fixed-rate setpoints per channel, shaped by the
+same speed and acceleration limits the firmware profiles with, checks every
+sample for self-collision with the FK engine, and encodes the result as the
+sampled stream frames the controllers play back (FRAME_FLAG_SAMPLED).
+"""
+
+from __future__ import annotations
+
+import numpy as np
+
+from src.io.motion_frames import (
+    TRAJECTORY_CHUNK_SAMPLES,
+    encode_stream_frames,
+    pack_trajectory,
+    script_digest,
+)
+
+from . import config
+from .fk_engine import get_joint_positions_dual_batch
+from .models import CompiledTrajectory, EvalIssue, ParsedSign
+from .servo_mapper import servo_array_to_joint_angles
+
+
+# Wire channel groups in order: (key suffix, first column, width)
+CHANNEL_GROUPS: list[tuple[str, int, int]] = [("", 0, 5), ("W", 5, 2), ("E", 7, 1), ("S", 8, 2)]
+NUM_CHANNELS: int = 10
+
+# Channel columns in JOINT_NAMES order: swing, abduction, elbow, wrist flexion, pronation
+_JOINT_COLUMNS: list[int] = [8, 9, 7, 5, 6]
+_SHOULDER_COLUMNS = slice(8, 10)
+
+# Joint positions index from get_joint_positions: elbow, wrist, hand tip
+_ELBOW, _WRIST, _HAND_TIP = 3, 4, 5
+
+_SIDE_PREFIX = {"left": "L", "right": "R"}
+_SETTLE_TOLERANCE_DEG = 0.05
+
+
+# ---------------------------------------------------------------------------
+# Public API
+# ---------------------------------------------------------------------------
+
+def compile_sign(parsed_sign: ParsedSign, rate_hz: int = config.TRAJECTORY_RATE_HZ) -> CompiledTrajectory:
+    """Compile a parsed sign into rate-limited setpoints for each arm it uses.
+
+    Keyframe targets are interpolated at rate_hz, then followed with the
+    firmware's per-channel speed/acceleration limits, so every sample is a
+    position the joint can actually reach by its time. Samples continue past
+    the last keyframe until every channel has landed (at most
+    TRAJECTORY_SETTLE_MAX_SEC longer).
+
+    Args:
+        parsed_sign: A fully-parsed sign.
+        rate_hz: Setpoints per second.
+
+    Returns:
+        A CompiledTrajectory with samples, driven masks and collision issues.
+
+    Raises:
+        ValueError: If the sign has no keyframes.
+    """
+    if not parsed_sign.keyframes:
+        raise ValueError(f"Sign '{parsed_sign.token}' has no keyframes")
+
+    sides = ["left", "right"] if parsed_sign.arm == "both" else [parsed_sign.arm]
+    key_times = np.array([keyframe.time for keyframe in parsed_sign.keyframes], dtype=float)
+    dt = 1.0 / rate_hz
+    times = np.arange(int(np.floor(key_times[-1] * rate_hz + 1e-9)) + 1) * dt
+    settle_count = int(round(config.TRAJECTORY_SETTLE_MAX_SEC * rate_hz))
+
+    issues: list[EvalIssue] = []
+    all_samples: dict[str, np.ndarray] = {}
+    driven: dict[str, np.ndarray] = {}
+
+    # Both arms are sampled (an unused one holds its pose) so the FK check sees both
+    for side in ("left", "right"):
+        targets = keyframe_channels(parsed_sign, side)
+        interpolated = np.column_stack([
+            np.interp(times, key_times, targets[:, column]) for column in range(NUM_CHANNELS)
+        ])
+        all_samples[side], settled = follow_rate_limited(interpolated, dt, settle_count)
+        if side not in sides:
+            continue
+        driven[side] = driven_channels(parsed_sign, side)
+        if not settled:
+            issues.append(EvalIssue(
+                level="WARN",
+                metric="trajectory_unsettled",
+                message=(
+                    f"{side} arm still moving {config.TRAJECTORY_SETTLE_MAX_SEC:.1f}s "
+                    f"after the last keyframe"
+                ),
+            ))
+
+    # Pad to a common length, holding the last sample
+    longest = max(len(samples) for samples in all_samples.values())
+    for side, samples in all_samples.items():
+        if len(samples) < longest:
+            hold = np.repeat(samples[-1:], longest - len(samples), axis=0)
+            all_samples[side] = np.vstack([samples, hold])
+    times = np.arange(longest) * dt
+
+    issues.extend(check_self_collision(all_samples["left"], all_samples["right"], times, sides))
+
+    return CompiledTrajectory(
+        token=parsed_sign.token,
+        rate_hz=rate_hz,
+        duration=max(float(parsed_sign.duration), float(times[-1])),
+        times=times,
+        samples={side: all_samples[side] for side in sides},
+        driven=driven,
+        issues=issues,
+    )
+
+
+def encode_trajectory(compiled: CompiledTrajectory, raw_sign: dict) -> bytes:
+    """Encode a compiled sign as a .traj blob (see motion_frames.pack_trajectory).
+
+    Args:
+        compiled: The compiled trajectory.
+        raw_sign: The script it was compiled from; its digest stamps the blob.
+
+    Returns:
+        The .traj file contents.
+    """
+    frames_by_side: dict[str, list[bytes]] = {}
+    for side, samples in compiled.samples.items():
+        prefix = _SIDE_PREFIX[side]
+        mask = compiled.driven[side]
+        keyframes = []
+        for time, row in zip(compiled.times, samples):
+            keyframe = {"time": round(float(time), 3)}
+            for suffix, first, width in CHANNEL_GROUPS:
+                if mask[first:first + width].any():
+                    keyframe[prefix + suffix] = [float(v) for v in row[first:first + width]]
+            keyframes.append(keyframe)
+        script = {
+            "token": compiled.token,
+            "duration": compiled.duration,
+            "timing": "timed",
+            "keyframes": keyframes,
+        }
+        frames_by_side[side] = encode_stream_frames(
+            script, side, chunk=TRAJECTORY_CHUNK_SAMPLES, sampled=True,
+        )
+    return pack_trajectory(script_digest(raw_sign), compiled.rate_hz, frames_by_side)
+
+
+# ---------------------------------------------------------------------------
+# Sampling
+# ---------------------------------------------------------------------------
+
+def keyframe_channels(parsed_sign: ParsedSign, side: str) -> np.ndarray:
+    """Gather one arm's channel targets at every keyframe.
+
+    Each group is held forward from the keyframe that last set it and
+    back-filled with its first value. A group the sign never sets holds
+    CHANNEL_REST_POSE, where the controllers leave it, rather than the
+    parser's 90 deg default.
+
+    Args:
+        parsed_sign: The sign.
+        side: "left" or "right".
+
+    Returns:
+        Kx10 array in wire channel order (hand, wrist, elbow, shoulder).
+    """
+    prefix = _SIDE_PREFIX[side]
+    raw_keyframes = _sorted_raw_keyframes(parsed_sign)
+
+    rows = np.tile(np.array(config.CHANNEL_REST_POSE, dtype=float), (len(raw_keyframes), 1))
+    for suffix, first, width in CHANNEL_GROUPS:
+        given = [kf.get(prefix + suffix) if isinstance(kf, dict) else None for kf in raw_keyframes]
+        held = next((values for values in given if values is not None), None)
+        if held is None:
+            continue
+        for kf_index, values in enumerate(given):
+            if values is not None:
+                held = values
+            rows[kf_index, first:first + width] = held
+    return rows
+
+
+def driven_channels(parsed_sign: ParsedSign, side: str) -> np.ndarray:
+    """Channels of one arm that any keyframe of the raw sign sets.
+
+    Args:
+        parsed_sign: The sign (its raw dict is consulted).
+        side: "left" or "right".
+
+    Returns:
+        10-element bool mask in wire channel order.
+    """
+    prefix = _SIDE_PREFIX[side]
+    raw_keyframes = _sorted_raw_keyframes(parsed_sign)
+
+    mask = np.zeros(NUM_CHANNELS, dtype=bool)
+    for suffix, first, width in CHANNEL_GROUPS:
+        if any(isinstance(kf, dict) and prefix + suffix in kf for kf in raw_keyframes):
+            mask[first:first + width] = True
+    return mask
+
+
+def _sorted_raw_keyframes(parsed_sign: ParsedSign) -> list:
+    """The raw keyframes in the parser's time order (one per parsed keyframe)."""
+    raw_keyframes = parsed_sign.raw.get("keyframes") or []
+    if isinstance(raw_keyframes, dict):
+        raw_keyframes = list(raw_keyframes.values())
+    return sorted(raw_keyframes, key=lambda kf: kf.get("time", 0.0) if isinstance(kf, dict) else 0.0)
+
+
+def follow_rate_limited(
+    targets: np.ndarray,
+    dt: float,
+    settle_count: int,
+) -> tuple[np.ndarray, bool]:
+    """Follow per-sample targets under CHANNEL_MAX_SPEED / CHANNEL_ACCEL.
+
+    Same rule as the firmware's profileServos: head for the target at the
+    speed that can still stop in the distance left (sqrt(2 a d), capped at
+    the max speed), change speed by at most a*dt per step, and land on the
+    target instead of overshooting it.
+
+    Args:
+        targets: Nx10 target positions, one row per sample.
+        dt: Seconds between samples.
+        settle_count: Most extra samples (holding the last target) to add
+                      while channels are still moving.
+
+    Returns:
+        Tuple of (samples, settled). samples is Mx10 with M >= N; settled is
+        False when channels were still moving after settle_count extra samples.
+    """
+    max_speed = np.array(config.CHANNEL_MAX_SPEED_DEG_PER_SEC)
+    accel = np.array(config.CHANNEL_ACCEL_DEG_PER_SEC2)
+
+    position = targets[0].astype(float)
+    velocity = np.zeros(NUM_CHANNELS)
+    samples = [position.copy()]
+
+    def step(target: np.ndarray) -> None:
+        nonlocal position, velocity
+        error = target - position
+        wanted = np.sign(error) * np.minimum(max_speed, np.sqrt(2.0 * accel * np.abs(error)))
+        velocity = velocity + np.clip(wanted - velocity, -accel * dt, accel * dt)
+        moved = position + velocity * dt
+        landed = np.sign(target - moved) != np.sign(error)
+        position = np.where(landed, target, moved)
+        velocity = np.where(landed, 0.0, velocity)
+        samples.append(position.copy())
+
+    for target in targets[1:]:
+        step(target)
+
+    final = targets[-1]
+    for _ in range(settle_count):
+        if np.all(np.abs(final - position) <= _SETTLE_TOLERANCE_DEG) and not velocity.any():
+            break
+        step(final)
+    settled = bool(np.all(np.abs(final - position) <= _SETTLE_TOLERANCE_DEG))
+
+    return np.array(samples), settled
+
+
+# ---------------------------------------------------------------------------
+# Collision check
+# ---------------------------------------------------------------------------
+
+def channels_to_joint_angles(samples: np.ndarray, side: str) -> np.ndarray:
+    """Convert wire-order channel samples to FK joint angles.
+
+    Servo channels are servo degrees, as the FK calibration expects. Shoulder
+    channels are degrees from the power-on pose, so SHOULDER_HOME_SERVO_DEG
+    is added to put them in the calibration's servo frame first.
+
+    Args:
+        samples: Nx10 samples in wire channel order (script units).
+        side: "left" or "right".
+
+    Returns:
+        Nx5 joint angles in radians, JOINT_NAMES order.
+    """
+    servo = np.array(samples, dtype=float)
+    servo[:, _SHOULDER_COLUMNS] += np.array(config.SHOULDER_HOME_SERVO_DEG)
+    return servo_array_to_joint_angles(servo[:, _JOINT_COLUMNS], side)
+
+
+def check_self_collision(
+    left_samples: np.ndarray,
+    right_samples: np.ndarray,
+    times: np.ndarray,
+    sides: list[str],
+) -> list[EvalIssue]:
+    """Check every sample of both arms against the torso and each other.
+
+    An elbow, wrist or hand tip inside the torso box (|x| < TORSO_HALF_WIDTH,
+    |y| < TORSO_HALF_DEPTH, below the shoulders) fails the sign. Left and
+    right wrists or hand tips closer than MIN_HAND_CLEARANCE are a warning
+    (contact may be part of the sign). Each finding is reported once, at the
+    first sample it occurs.
+
+    Args:
+        left_samples: Nx10 left arm samples (wire channel order).
+        right_samples: Nx10 right arm samples.
+        times: N sample times in seconds.
+        sides: Arms the sign drives; only their torso contact is checked.
+
+    Returns:
+        List of FAIL-level "self_collision" and WARN-level "arm_proximity" issues.
+    """
+    left_angles = channels_to_joint_angles(left_samples, "left")
+    right_angles = channels_to_joint_angles(right_samples, "right")
+    left_positions, right_positions = get_joint_positions_dual_batch(left_angles, right_angles)
+
+    issues: list[EvalIssue] = []
+    points = {"elbow": _ELBOW, "wrist": _WRIST, "hand": _HAND_TIP}
+
+    for side, positions in (("left", left_positions), ("right", right_positions)):
+        if side not in sides:
+            continue
+        for point_name, point_index in points.items():
+            xyz = positions[:, point_index, :]
+            inside = (
+                (np.abs(xyz[:, 0]) < config.TORSO_HALF_WIDTH)
+                & (np.abs(xyz[:, 1]) < config.TORSO_HALF_DEPTH)
+                & (xyz[:, 2] < 0.0)
+            )
+            if inside.any():
+                sample = int(np.argmax(inside))
+                issues.append(EvalIssue(
+                    level="FAIL",
+                    metric="self_collision",
+                    message=(
+                        f"{side} {point_name} inside the torso at t={times[sample]:.2f}s "
+                        f"(sample {sample})"
+                    ),
+                    joint_name=f"{side}_{point_name}",
+                    value=float(times[sample]),
+                ))
+
+    if len(sides) == 2:
+        for point_name in ("wrist", "hand"):
+            point_index = points[point_name]
+            gap = np.linalg.norm(
+                left_positions[:, point_index, :] - right_positions[:, point_index, :], axis=1,
+            )
+            close = gap < config.MIN_HAND_CLEARANCE
+            if close.any():
+                sample = int(np.argmax(close))
+                issues.append(EvalIssue(
+                    level="WARN",
+                    metric="arm_proximity",
+                    message=(
+                        f"left and right {point_name} {gap[sample]:.2f}in apart "
+                        f"at t={times[sample]:.2f}s (sample {sample})"
+                    ),
+                    joint_name=point_name,
+                    value=float(gap[sample]),
+                    limit=config.MIN_HAND_CLEARANCE,
+                ))
+
+    return issues
@@ -1,11 +1,36 @@
 import time
 
+from src.io.fileIO import SttUpdate
+from src.io.speculation import SpeculativeUtterance
 from src.text_to_ASL.translate_AI import translate_to_asl_gloss
 from src.text_to_emotion.emotion_AI import translate_to_emotions
 
 
+def push_tokens(file_io, text, tokens, first=0, utterance=None):
+    """Push tokens[first:] with their emotions; utterance tags them as speculative (see FileIOManager)."""
+    emotions = translate_to_emotions(text)
+    if not emotions:
+        emotions = ["neutral"]
+    token_count = len(tokens)
+    emotion_count = len(emotions)
+
+    batch = []
+    for idx in range(first, token_count):
+        # Map gloss tokens across chunk-level emotions from the source text.
+        # This preserves multi-chunk emotion variation while syncing to motion start.
+        emotion_idx = min(emotion_count - 1, (idx * emotion_count) // token_count)
+        motion_emotion = emotions[emotion_idx]
+        tag = None if utterance is None else (utterance, idx)
+        batch.append((tokens[idx], tag))
+        file_io.push_motion_emotion(motion_emotion, tag)
+    # All at once, so db_io resolves the whole sentence in one query
+    file_io.push_asl_tokens(batch)
+
+
 def run_ai(file_io):
     print("[AI_IO] Started AI translation loop.")
+    utterance = None  # SpeculativeUtterance being spoken (incremental STT only)
+    utterance_count = 0
 
     while not file_io.shutdown.is_set():
         if not file_io.stt_new_signal.wait(timeout=0.5):
@@ -13,21 +38,37 @@ def run_ai(file_io):
 
         while not file_io.stt_line_queue.empty() and not file_io.shutdown.is_set():
             line = file_io.pop_stt_line()
-            tokens = translate_to_asl_gloss(line)
-            if not tokens:
+            if not isinstance(line, SttUpdate):
+                tokens = translate_to_asl_gloss(line)
+                if tokens:
+                    push_tokens(file_io, line, tokens)
                 continue
-            emotions = translate_to_emotions(line)
-            if not emotions:
-                emotions = ["neutral"]
-            token_count = len(tokens)
-            emotion_count = len(emotions)
-
-            for idx, token in enumerate(tokens):
-                # Map gloss tokens across chunk-level emotions from the source text.
-                # This preserves multi-chunk emotion variation while syncing to motion start.
-                emotion_idx = min(emotion_count - 1, (idx * emotion_count) // token_count)
-                motion_emotion = emotions[emotion_idx]
-                file_io.push_asl_token(token)
-                file_io.push_motion_emotion(motion_emotion)
-
-        time.sleep(0.01)
\ No newline at end of file
+
+            if not line.final:
+                # Only the newest hypothesis matters; skip ones already superseded
+                if not file_io.stt_line_queue.empty():
+                    continue
+                if utterance is None:
+                    utterance_count += 1
+                    utterance = SpeculativeUtterance(utterance_count, translate_to_asl_gloss)
+                first = len(utterance.released)
+                if utterance.update(line.text):
+                    print(f"[AI_IO] Speculating {utterance.released[first:]}")
+                    push_tokens(file_io, " ".join(utterance.agreed), utterance.released, first, utterance.id)
+                continue
+
+            # Final transcript: send what the speculation has not, correcting it if needed
+            if utterance is None:
+                tokens, first = translate_to_asl_gloss(line.text), 0
+            else:
+                tokens, agreed = utterance.finish(line.text)
+                first = len(utterance.released)
+                if agreed < first:
+                    first = file_io.retract_tokens(utterance.id, agreed)
+                    print(f"[AI_IO] Correcting speculation after {tokens[:agreed]}, resuming at token {first}")
+                file_io.finish_utterance(utterance.id)
+                utterance = None
+            if tokens:
+                push_tokens(file_io, line.text, tokens, first)
+
+        time.sleep(0.01)
@@ -1,11 +1,24 @@
 import time
 
 from src.database.db_connection import DatabaseConnection
-from src.io.sign_resolution import enqueue_motions_for_token
+from src.io.sign_resolution import enqueue_motions_for_token, resolve_signs, warm_signs
+
+
+def process_queued_tokens(file_io):
+    """Resolve and enqueue every queued token, fetching the uncached ones of each batch in one query."""
+    while not file_io.asl_token_queue.empty() and not file_io.shutdown.is_set():
+        batch = []
+        while not file_io.asl_token_queue.empty():
+            batch.extend(file_io.pop_asl_tokens())
+        resolve_signs(token for token, _ in batch)
+        for token, tag in batch:
+            enqueue_motions_for_token(file_io, token, log=True, log_tag="[DB_IO]", tag=tag)
+            file_io.release_tag(tag)
 
 
 def run_database(file_io):
     DatabaseConnection.initialize()
+    print(f"[DB_IO] Cached {warm_signs()} common signs.")
     print("[DB_IO] Started database I/O handler loop.")
 
     while not file_io.shutdown.is_set():
@@ -13,10 +26,8 @@ def run_database(file_io):
         if not file_io.asl_new_signal.wait(timeout=0.5):
             continue
 
-        # Process all tokens in the queue
-        while not file_io.asl_token_queue.empty() and not file_io.shutdown.is_set():
-            token = file_io.pop_asl_token()
-            enqueue_motions_for_token(file_io, token, log=True, log_tag="[DB_IO]")
+        # Process all tokens in the queue, fetching the uncached ones in one query
+        process_queued_tokens(file_io)
 
         # Reset event after processing all tokens
         file_io.asl_new_signal.clear()
@@ -1,5 +1,10 @@
-from queue import Queue
-from threading import Event
+from collections import namedtuple
+from queue import Empty, Queue
+from threading import Event, Lock
+
+# A speech-to-text hypothesis in incremental mode (see stt_io.INCREMENTAL_STT).
+# Interim ones (final=False) cover the utterance so far and may still change.
+SttUpdate = namedtuple("SttUpdate", "text final")
 
 
 class FileIOManager:
@@ -8,49 +13,183 @@ class FileIOManager:
         self.asl_token_queue = Queue()
         self.motion_queue = Queue()
         self.motion_emotion_queue = Queue()
+        self.motion_cancel_queue = Queue()
         
         self.stt_new_signal = Event()
         self.asl_new_signal = Event()
         self.motion_new_signal = Event()
         self.motion_emotion_signal = Event()
         self.shutdown = Event()
+        self.motion_wake = None  # set by motion_io: interrupts its wait on the controllers
+
+        # Tokens, scripts and emotions carry a tag: None, or (utterance, token index)
+        # for tokens translated ahead of the final transcript (see retract_tokens).
+        # An utterance's entries are dropped once it is final and nothing tagged with
+        # it is left on the way to motion_io (see finish_utterance).
+        self.retract_lock = Lock()
+        self.retracted = {}        # utterance -> first token index dropped
+        self.motion_progress = {}  # utterance -> last token index motion_io took a script of
+        self.tagged = {}           # utterance -> its tokens, scripts and emotions not yet consumed
+        self.finished = set()      # utterances whose final transcript is in
         
     def push_stt_line(self, line):
         self.stt_line_queue.put(line)
         self.stt_new_signal.set()
 
+    def push_stt_update(self, text, final):
+        self.push_stt_line(SttUpdate(text, final))
+
     def pop_stt_line(self):
         line = self.stt_line_queue.get()
         if self.stt_line_queue.empty():
             self.stt_new_signal.clear()
         return line
     
-    def push_asl_token(self, token):
-        self.asl_token_queue.put(token)
-        self.asl_new_signal.set()
+    def push_asl_token(self, token, tag=None):
+        """A tagged token stays counted until db_io calls release_tag for it."""
+        self.push_asl_tokens([(token, tag)])
     
-    def pop_asl_token(self):
-        token = self.asl_token_queue.get()
+    def push_asl_tokens(self, items):
+        """
+        Queue a sentence's (token, tag) pairs as one item, so db_io takes them as one
+        batch and resolves them in one query (see sign_resolution.resolve_signs).
+        """
+        kept = [(token, tag) for token, tag in items if self._hold(tag)]
+        if not kept:
+            return
+        self.asl_token_queue.put(kept)
+        self.asl_new_signal.set()
+
+    def pop_asl_tokens(self):
+        """Returns the next pushed batch, a list of (token, tag)."""
+        batch = self.asl_token_queue.get()
         if self.asl_token_queue.empty():
             self.asl_new_signal.clear()
-        return token
+        return batch
     
-    def push_motion_script(self, motion_script):
-        self.motion_queue.put(motion_script)
+    def push_motion_script(self, motion_script, tag=None):
+        if not self._hold(tag):
+            return
+        self.motion_queue.put((motion_script, tag))
         self.motion_new_signal.set()
 
     def pop_motion_script(self):
-        motion_script = self.motion_queue.get()
+        motion_script, tag = self.motion_queue.get()
+        if tag is not None:
+            with self.retract_lock:
+                if tag[0] not in self.finished:
+                    self.motion_progress[tag[0]] = max(self.motion_progress.get(tag[0], -1), tag[1])
+                self._release(tag)
         if self.motion_queue.empty():
             self.motion_new_signal.clear()
         return motion_script
 
-    def push_motion_emotion(self, emotion):
-        self.motion_emotion_queue.put(emotion)
+    def push_motion_emotion(self, emotion, tag=None):
+        if not self._hold(tag):
+            return
+        self.motion_emotion_queue.put((emotion, tag))
         self.motion_emotion_signal.set()
 
     def pop_motion_emotion(self):
-        emotion = self.motion_emotion_queue.get()
+        emotion, tag = self.motion_emotion_queue.get()
+        self.release_tag(tag)
         if self.motion_emotion_queue.empty():
             self.motion_emotion_signal.clear()
-        return emotion
\ No newline at end of file
+        return emotion
+
+    def is_retracted(self, tag):
+        with self.retract_lock:
+            return self._is_retracted(tag)
+
+    def _is_retracted(self, tag):
+        return tag is not None and tag[1] >= self.retracted.get(tag[0], float("inf"))
+
+    def _hold(self, tag):
+        """Count a tagged item about to be queued; False if its token was retracted."""
+        if tag is None:
+            return True
+        with self.retract_lock:
+            if self._is_retracted(tag):
+                return False
+            self.tagged[tag[0]] = self.tagged.get(tag[0], 0) + 1
+        return True
+
+    def release_tag(self, tag):
+        """A tagged item has been consumed (db_io calls this once a token's scripts are queued)."""
+        if tag is None:
+            return
+        with self.retract_lock:
+            self._release(tag)
+
+    def _release(self, tag):
+        self.tagged[tag[0]] -= 1
+        self._forget_if_done(tag[0])
+
+    def _forget_if_done(self, utterance):
+        if utterance in self.finished and not self.tagged.get(utterance):
+            self.finished.discard(utterance)
+            self.tagged.pop(utterance, None)
+            self.retracted.pop(utterance, None)
+            self.motion_progress.pop(utterance, None)
+
+    def finish_utterance(self, utterance):
+        """
+        The utterance's final transcript is in: it gets no more tagged tokens and is not
+        retracted again, so its entries go once its last tagged item is consumed.
+        """
+        with self.retract_lock:
+            self.finished.add(utterance)
+            self.motion_progress.pop(utterance, None)
+            self._forget_if_done(utterance)
+
+    def retract_tokens(self, utterance, first):
+        """
+        Drop an utterance's tokens from index first on, with their scripts and emotions,
+        wherever they have not reached motion_io yet. Tokens motion_io has started stay.
+        Returns the index the utterance now ends at: first, or just past the last token
+        motion_io has taken.
+        """
+        with self.retract_lock:
+            end = max(first, self.motion_progress.get(utterance, -1) + 1)
+            self.retracted[utterance] = end
+            with self.asl_token_queue.mutex:
+                batches = [self._drop_retracted(batch) for batch in self.asl_token_queue.queue]
+                self.asl_token_queue.queue.clear()
+                self.asl_token_queue.queue.extend(batch for batch in batches if batch)
+            for q in (self.motion_queue, self.motion_emotion_queue):
+                with q.mutex:
+                    kept = self._drop_retracted(q.queue)
+                    q.queue.clear()
+                    q.queue.extend(kept)
+        return end
+
+    def _drop_retracted(self, items):
+        """The (value, tag) items not retracted; the dropped ones stop being counted."""
+        kept = []
+        for item in items:
+            if self._is_retracted(item[1]):
+                self.tagged[item[1][0]] -= 1
+            else:
+                kept.append(item)
+        return kept
+
+    def cancel_motion(self, command="FLUSH"):
+        """
+        Drop every token and motion script not yet sent to the controllers, and have
+        motion_io send them command: "STOP" (halt where they are), "FLUSH" (finish the
+        current sign) or "REST" (halt and return to rest).
+        """
+        for q in (self.asl_token_queue, self.motion_queue, self.motion_emotion_queue):
+            while True:
+                try:
+                    item = q.get_nowait()
+                except Empty:
+                    break
+                for _, tag in (item if q is self.asl_token_queue else [item]):
+                    self.release_tag(tag)
+        self.asl_new_signal.clear()
+        self.motion_emotion_signal.clear()
+        self.motion_cancel_queue.put(command)
+        self.motion_new_signal.set()
+        if self.motion_wake is not None:
+            self.motion_wake()
\ No newline at end of file
@@ -0,0 +1,326 @@
+"""
+Binary motion frame encoder for the ESP32 arm controllers.
+
+Mirrors the BINARY FRAME PROTOCOL section of arm_controller.cpp: a
+length-prefixed frame with fixed-width joint fields and a CRC-16/CCITT-FALSE.
+A frame carries one arm's channels only, so each controller gets its own.
+"""
+
+from __future__ import annotations
+
+import hashlib
+import json
+import struct
+
+FRAME_MAGIC = 0xA5
+FRAME_TYPE_MOTION = 0x01
+FRAME_TYPE_STORE = 0x02
+FRAME_TYPE_PLAY = 0x03
+FRAME_TYPE_STREAM_BEGIN = 0x04
+FRAME_TYPE_STREAM_KEYS = 0x05
+FRAME_FLAG_TIMED = 0x01
+FRAME_FLAG_SYNC = 0x02  # hold until "!GO" so both arms start together
+FRAME_FLAG_FINE = 0x04  # servo fields are uint16 tenths of a degree
+FRAME_FLAG_SAMPLED = 0x08  # keyframes are fixed-rate setpoints (fk_tool compile)
+
+SERVO_SCALE = 10  # firmware SERVO_SCALE: servo position units per degree
+
+CHANNEL_HAND = 0x01
+CHANNEL_WRIST = 0x02
+CHANNEL_ELBOW = 0x04
+CHANNEL_SHOULDER = 0x08
+
+MAX_TOKEN_BYTES = 31  # firmware MAX_TOKEN_LEN - 1
+MAX_KEYFRAMES = 16    # firmware MAX_KEYFRAMES
+
+STREAM_CHUNK_KEYFRAMES = 4  # keyframes per STREAM_KEYS frame (firmware max: MAX_KEYFRAMES - 2)
+
+MAX_QUEUE = 8  # firmware MAX_QUEUE: command slots, i.e. the credits a controller boots with
+
+SIGN_CACHE_SIZE = 32  # firmware SIGN_CACHE_SIZE
+SIGN_ID_REST = 0      # rest pose baked into firmware; uploaded ids start at 1
+
+# (channel bit, key suffix, expected length) in firmware field order
+_CHANNELS = (
+    (CHANNEL_HAND, "", 5),
+    (CHANNEL_WRIST, "W", 2),
+    (CHANNEL_ELBOW, "E", 1),
+    (CHANNEL_SHOULDER, "S", 2),
+)
+
+_SIDE_PREFIX = {"left": "L", "right": "R"}
+
+# Side-neutral JSON channel keys (firmware NEUTRAL_*_KEY), by key suffix
+_NEUTRAL_KEYS = {"": "H", "W": "W", "E": "E", "S": "S"}
+_JSON_FIELDS = ("token", "duration", "timing")  # script fields the firmware reads
+
+
+def _crc16_table() -> tuple:
+    table = []
+    for byte in range(256):
+        crc = byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+        table.append(crc & 0xFFFF)
+    return tuple(table)
+
+
+_CRC16_TABLE = _crc16_table()
+
+
+def crc16_ccitt(data: bytes) -> int:
+    """CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF), same as the firmware's crc16Ccitt."""
+    crc = 0xFFFF
+    for byte in data:
+        crc = ((crc << 8) & 0xFFFF) ^ _CRC16_TABLE[(crc >> 8) ^ byte]
+    return crc
+
+
+def _servo_byte(value) -> int:
+    return max(0, min(255, int(round(float(value)))))
+
+
+def _servo_tenths(value) -> int:
+    return max(0, min(180 * SERVO_SCALE, int(round(float(value) * SERVO_SCALE))))
+
+
+def _centi_degrees(value) -> int:
+    return max(-32768, min(32767, int(round(float(value) * 100))))
+
+
+def _ms(seconds) -> int:
+    return max(0, min(0xFFFF, int(round(float(seconds) * 1000))))
+
+
+def encode_keyframe(frame: dict, prefix: str, fine: bool = False) -> bytes:
+    """
+    Encode one keyframe's channels for the arm whose JSON keys start with prefix ("L"/"R").
+    fine encodes servo fields as tenths of a degree (FRAME_FLAG_FINE).
+    """
+    mask = 0
+    fields = bytearray()
+    for bit, suffix, count in _CHANNELS:
+        values = frame.get(prefix + suffix)
+        if not isinstance(values, (list, tuple)) or len(values) != count:
+            continue
+        mask |= bit
+        if bit == CHANNEL_SHOULDER:
+            fields += struct.pack("<hh", *(_centi_degrees(v) for v in values))
+        elif fine:
+            fields += struct.pack(f"<{count}H", *(_servo_tenths(v) for v in values))
+        else:
+            fields += bytes(_servo_byte(v) for v in values)
+    return struct.pack("<HB", _ms(frame.get("time", 0.0)), mask) + bytes(fields)
+
+
+def _frame(payload: bytes) -> bytes:
+    return (
+        struct.pack("<BH", FRAME_MAGIC, len(payload))
+        + bytes(payload)
+        + struct.pack("<H", crc16_ccitt(payload))
+    )
+
+
+def _keyframes(script: dict) -> list:
+    keyframes = script.get("keyframes") or []
+    if isinstance(keyframes, dict):
+        keyframes = list(keyframes.values())
+    return [f for f in keyframes if isinstance(f, dict)]
+
+
+def project_script(script: dict, side: str) -> dict:
+    """
+    JSON command for one arm: the script fields the firmware reads, and per
+    keyframe only this arm's channels, under the side-neutral H/W/E/S keys.
+    Keyframes keep their time even when this arm has nothing in them.
+    """
+    prefix = _SIDE_PREFIX[side]
+    wire = {field: script[field] for field in _JSON_FIELDS if field in script}
+    frames = []
+    for frame in _keyframes(script):
+        projected = {"time": frame.get("time", 0.0)}
+        for suffix, neutral in _NEUTRAL_KEYS.items():
+            if prefix + suffix in frame:
+                projected[neutral] = frame[prefix + suffix]
+        frames.append(projected)
+    wire["keyframes"] = frames
+    return wire
+
+
+def _needs_fine(keyframes: list, prefix: str) -> bool:
+    """True when any of this arm's servo angles has a fraction a whole degree would drop."""
+    for frame in keyframes:
+        for bit, suffix, count in _CHANNELS:
+            values = frame.get(prefix + suffix)
+            if bit == CHANNEL_SHOULDER or not isinstance(values, (list, tuple)) or len(values) != count:
+                continue
+            if any(_servo_tenths(v) % SERVO_SCALE for v in values):
+                return True
+    return False
+
+
+def _plan_header(script: dict, sync: bool = False, fine: bool = False, sampled: bool = False) -> bytes:
+    """flags, duration and token, shared by motion and stream headers."""
+    token = str(script.get("token", "")).encode("ascii", errors="replace")[:MAX_TOKEN_BYTES]
+    flags = FRAME_FLAG_TIMED if script.get("timing") == "timed" else 0
+    if sampled:
+        flags |= FRAME_FLAG_TIMED | FRAME_FLAG_SAMPLED
+    if sync:
+        flags |= FRAME_FLAG_SYNC
+    if fine:
+        flags |= FRAME_FLAG_FINE
+    return struct.pack("<BHB", flags, _ms(script.get("duration", 1.0)), len(token)) + token
+
+
+def _motion_body(script: dict, side: str, sync: bool = False) -> bytes:
+    """flags..keyframes of a motion payload (everything after the type and seq bytes)."""
+    prefix = _SIDE_PREFIX[side]
+    keyframes = _keyframes(script)[:MAX_KEYFRAMES]
+    fine = _needs_fine(keyframes, prefix)
+    body = bytearray(_plan_header(script, sync, fine))
+    body += struct.pack("<B", len(keyframes))
+    for frame in keyframes:
+        body += encode_keyframe(frame, prefix, fine)
+    return bytes(body)
+
+
+def needs_stream(script: dict) -> bool:
+    """True when a script has more keyframes than one motion frame can carry."""
+    return len(_keyframes(script)) > MAX_KEYFRAMES
+
+
+def encode_motion_frame(script: dict, side: str, seq: int = 0, sync: bool = False) -> bytes:
+    """
+    Encode a motion script as a binary frame for one controller.
+    side is "left" or "right"; keyframes may be a list or a dict of frames.
+    seq (1..255) is echoed back in STARTED/DONE; 0 asks for a plain ACK.
+    sync holds the sign on the controller until a matching "!GO".
+    """
+    return _frame(bytes([FRAME_TYPE_MOTION, seq]) + _motion_body(script, side, sync))
+
+
+def with_seq(frame: bytes, seq: int, sync: bool = False) -> bytes:
+    """
+    A MOTION or STREAM_BEGIN frame encoded with seq 0 and no sync flag,
+    re-stamped with seq (and FRAME_FLAG_SYNC). Lets the host encode a script
+    once and reuse the bytes for every send; only the CRC is recomputed.
+    """
+    payload = bytearray(frame[3:-2])
+    payload[1] = seq
+    if sync:
+        payload[2] |= FRAME_FLAG_SYNC
+    return _frame(bytes(payload))
+
+
+def encode_store_frame(script: dict, side: str, sign_id: int) -> bytes:
+    """Frame that uploads a script into the controller's sign cache under sign_id (1..SIGN_CACHE_SIZE-1)."""
+    if not SIGN_ID_REST < sign_id < SIGN_CACHE_SIZE:
+        raise ValueError(f"sign cache id out of range: {sign_id}")
+    return _frame(bytes([FRAME_TYPE_STORE, sign_id]) + _motion_body(script, side))
+
+
+def encode_play_frame(sign_id: int, seq: int = 0) -> bytes:
+    """Frame that plays a cached script by id."""
+    return _frame(bytes([FRAME_TYPE_PLAY, seq, sign_id]))
+
+
+def encode_stream_frames(script: dict, side: str, chunk: int = STREAM_CHUNK_KEYFRAMES,
+                         seq: int = 0, sync: bool = False, sampled: bool = False) -> list:
+    """
+    Encode a script of any length as a STREAM_BEGIN frame followed by
+    STREAM_KEYS frames of up to `chunk` keyframes each. The firmware answers
+    every absorbed chunk with "NEXT"; motion_io uses that to pace the rest.
+    sampled marks the keyframes as fixed-rate setpoints the firmware writes
+    as they fall due (FRAME_FLAG_SAMPLED).
+    """
+    prefix = _SIDE_PREFIX[side]
+    keyframes = _keyframes(script)[:0xFFFF]
+    fine = _needs_fine(keyframes, prefix)
+    frames = [_frame(
+        bytes([FRAME_TYPE_STREAM_BEGIN, seq]) + _plan_header(script, sync, fine, sampled)
+        + struct.pack("<H", len(keyframes))
+    )]
+    for start in range(0, len(keyframes), chunk):
+        part = keyframes[start:start + chunk]
+        body = bytearray([FRAME_TYPE_STREAM_KEYS, len(part)])
+        for frame in part:
+            body += encode_keyframe(frame, prefix, fine)
+        frames.append(_frame(bytes(body)))
+    return frames
+
+
+# ---------------------------------------------------------------------------
+# Compiled trajectories (written by `python -m src.fk_tool compile`)
+# ---------------------------------------------------------------------------
+# A .traj file holds a sign's sampled stream frames for each arm it drives,
+# stamped with the digest of the script they were compiled from:
+#
+#   magic   4 bytes  TRAJECTORY_MAGIC
+#   version uint8    TRAJECTORY_VERSION
+#   digest  20 bytes script_digest() of the source script
+#   rate    uint16   samples per second
+#   arms    uint8, then per arm:
+#     side   uint8   ord("L") / ord("R")
+#     count  uint16  frames, then each frame as sent (seq 0, no sync flag)
+
+TRAJECTORY_MAGIC = b"ASLT"
+TRAJECTORY_VERSION = 1
+TRAJECTORY_CHUNK_SAMPLES = 12  # samples per STREAM_KEYS frame (firmware max: MAX_KEYFRAMES - 2)
+
+_DIGEST_FIELDS = ("token", "duration", "timing", "keyframes")  # what the motion depends on
+
+
+def script_digest(script: dict) -> bytes:
+    """SHA-1 over the fields of a script that shape its motion; changes with any edit to them."""
+    content = {field: script.get(field) for field in _DIGEST_FIELDS}
+    return hashlib.sha1(
+        json.dumps(content, sort_keys=True, separators=(",", ":"), default=str).encode("utf-8")
+    ).digest()
+
+
+def pack_trajectory(digest: bytes, rate_hz: int, frames_by_side: dict) -> bytes:
+    """Serialize per-arm frame lists ({"left": [...], "right": [...]}) as a .traj blob."""
+    blob = bytearray(TRAJECTORY_MAGIC + bytes([TRAJECTORY_VERSION]) + digest)
+    blob += struct.pack("<HB", rate_hz, len(frames_by_side))
+    for side, frames in frames_by_side.items():
+        blob += struct.pack("<BH", ord(_SIDE_PREFIX[side]), len(frames))
+        for frame in frames:
+            blob += frame
+    return bytes(blob)
+
+
+def stream_duration(frame: bytes) -> float:
+    """Seconds declared in a MOTION or STREAM_BEGIN frame's header."""
+    return struct.unpack_from("<H", frame, 6)[0] / 1000.0
+
+
+def unpack_trajectory(blob: bytes):
+    """
+    Inverse of pack_trajectory: (digest, rate_hz, {side: [frames]}).
+    Raises ValueError on anything that isn't a well-formed .traj blob.
+    """
+    header = len(TRAJECTORY_MAGIC) + 1 + 20
+    if len(blob) < header + 3 or blob[:4] != TRAJECTORY_MAGIC or blob[4] != TRAJECTORY_VERSION:
+        raise ValueError("not a trajectory blob")
+    digest = bytes(blob[5:header])
+    rate_hz, arm_count = struct.unpack_from("<HB", blob, header)
+    pos = header + 3
+    sides = {ord(prefix): side for side, prefix in _SIDE_PREFIX.items()}
+    frames_by_side = {}
+    for _ in range(arm_count):
+        if pos + 3 > len(blob) or blob[pos] not in sides:
+            raise ValueError("bad trajectory arm header")
+        side = sides[blob[pos]]
+        (count,) = struct.unpack_from("<H", blob, pos + 1)
+        pos += 3
+        frames = []
+        for _ in range(count):
+            if pos + 3 > len(blob) or blob[pos] != FRAME_MAGIC:
+                raise ValueError("bad trajectory frame")
+            end = pos + 3 + (blob[pos + 1] | blob[pos + 2] << 8) + 2
+            if end > len(blob):
+                raise ValueError("truncated trajectory frame")
+            frames.append(bytes(blob[pos:end]))
+            pos = end
+        frames_by_side[side] = frames
+    return digest, rate_hz, frames_by_side
@@ -1,13 +1,107 @@
 # src/io/motion_io.py
-import json, serial, time, threading
+import json, os, queue, serial, time, threading
 from bson import ObjectId
 
 from src.cache.rest_cache import REST_LEFT, REST_RIGHT
+from src.cache.fingerspelling_cache import FINGERSPELL_CACHE
+from src.cache.plan_cache import PLAN_CACHE
+from src.cache.verdict_cache import VERDICT_CACHE
+from src.fk_tool.precheck import precheck_script
+from src.io.motion_frames import (
+    MAX_QUEUE, SIGN_CACHE_SIZE, SIGN_ID_REST,
+    encode_motion_frame, encode_play_frame, encode_store_frame,
+    encode_stream_frames, needs_stream, project_script, script_digest,
+    stream_duration, unpack_trajectory, with_seq,
+)
 
 # ACK timeout in seconds when waiting for Arduino to finish a motion
 ACK_TIMEOUT = 8.0
 
-# Smart delays: post-motion pause before sending the next command
+# Timed playback: the firmware interpolates keyframe N -> N+1 across exactly
+# time[N+1] - time[N] and holds the last pose until "duration", so a sign's
+# length is known before it is sent. The ACK wait then becomes
+# duration + TIMED_ACK_MARGIN instead of the worst-case ACK_TIMEOUT.
+TIMED_PLAYBACK = True
+TIMED_ACK_MARGIN = 4.0  # lead-in to keyframe 0 (shoulders end-to-end) + serial slack
+
+# Wire format for motion commands: "binary" sends a compact per-arm frame
+# (see motion_frames.py), ~10x smaller than JSON and with no parse on the
+# ESP32. "json" sends one JSON line per arm, handy for debugging: the script
+# projected onto that arm's channels under side-neutral H/W/E/S keys.
+WIRE_FORMAT = "binary"
+
+# Controller sign cache (binary wire format only): fingerspelling letters are
+# uploaded once per connect and the rest pose is baked into the firmware, so
+# those scripts go out as a 7-byte PLAY frame instead of their keyframes.
+DEVICE_SIGN_CACHE = True
+READY_TIMEOUT = 3.0    # wait for the firmware boot banner after opening the port
+STORE_TIMEOUT = 0.5    # per-upload wait for "STORED <id>"
+
+# Signs with more keyframes than one frame holds are streamed (binary only):
+# a header plus chunks, with STREAM_WINDOW chunks in flight and one more sent
+# per "NEXT" from the controller, so its command queue never overflows.
+STREAM_WINDOW = 3
+
+# Safety precheck: every script is checked once per version (VERDICT_CACHE,
+# keyed by content) against the controllers' channel limits and the fk_tool
+# torso geometry. A failing one is logged when its plan is compiled; with
+# PRECHECK_REFUSES it is not sent at all. The limits and torso dimensions are
+# still unmeasured placeholders that many seeded signs exceed, and the firmware
+# clamps to the same limits regardless, so refusing stays off until the stops
+# are measured.
+SAFETY_PRECHECK = True
+PRECHECK_REFUSES = False
+
+# Compiled trajectories (binary only): a sign with a <token>.traj file in
+# TRAJECTORY_DIR, written by `python -m src.fk_tool compile`, is sent as that
+# file's fixed-rate setpoint stream instead of its keyframes. Files compiled
+# from an older version of the script (digest mismatch) are ignored.
+TRAJECTORY_DIR = os.getenv("ASL_TRAJECTORY_DIR")
+
+# Pipelined sends: every command carries a sequence number and up to
+# MOTION_WINDOW of them may be in flight per controller, so the next sign is
+# already parsed and queued when the current one ends. The controller answers
+# "STARTED <seq> <credits>" / "DONE <seq> <credits>", where credits is its
+# free command slots; nothing is sent while that is 0. 1 = stop-and-wait.
+MOTION_WINDOW = 3
+
+# Controller output is read by a blocking reader thread per port, so the motion
+# thread sleeps on it instead of polling; WAIT_SLICE caps each wait, for the
+# periodic pings, deadlines and shutdown.
+WAIT_SLICE = 0.1  # s
+
+# Synchronized start for two-handed signs: both arms hold the sign and report
+# "READY <seq>", then each gets "!GO <seq> <ms>" naming the same instant,
+# SYNC_GO_LEAD from now, on its own clock. Clock offsets come from "!PING" /
+# "PONG" round trips every SYNC_PING_INTERVAL (lowest-latency recent sample).
+SYNC_START = True
+SYNC_GO_LEAD = 0.02        # s; covers writing GO to both ports
+SYNC_PING_INTERVAL = 2.0   # s
+SYNC_PING_SAMPLES = 8
+SYNC_CLOCK_WAIT = 0.25     # s; how long a two-handed sign waits for the first PONGs after a connect
+
+# Firmware timing counters: after a controller has run new commands, ask it
+# for "!STATS" at most every STATS_INTERVAL and log the reply (format in the
+# STATISTICS section of arm_controller.cpp). 0 = never.
+STATS_INTERVAL = 60.0  # s
+
+# Link speed: controllers boot at run_motion's baud. Once a port is open the
+# host proposes FAST_BAUD with "!BAUD <rate>", both sides switch, and a
+# "!PING" echo at the new rate confirms the link. Anything else falls back to
+# the boot rate; the firmware reverts on its own when no PING arrives within
+# its BAUD_CONFIRM_MS. None = stay at the boot rate.
+FAST_BAUD = 921600
+BAUD_CONFIRM_TIMEOUT = 0.3  # per PING attempt at the new rate
+BAUD_CONFIRM_TRIES = 3
+BAUD_REVERT_WAIT = 1.2      # > firmware BAUD_CONFIRM_MS
+
+# Idle rest: a controller with no command for IDLE_REST seconds glides to its rest
+# pose on its own and abandons it as soon as a command arrives, so switching the
+# active arm no longer sends a rest and waits for it. None = firmware idle rest off
+# ("!IDLE 0") and the inactive arm gets an explicit REST_LEFT / REST_RIGHT.
+IDLE_REST = 1.5  # s
+
+# Smart delays: post-motion pause before sending the next command (stop-and-wait only)
 # Fingerspelling (single letter): short delay for smooth letter-to-letter flow
 # Full signs: longer delay for natural sign-to-sign pacing
 FINGERSPELL_POST_DELAY = 0.03   # 30 ms between letters
@@ -35,6 +129,11 @@ def connect_serial(port, baud, name):
                 except:
                     pass
             print(f"[MOTION_IO] ✓ Connected to {name} controller at {port}")
+            # Opening the port resets the ESP32; anything sent before setup() finishes is lost
+            wait_for_line(ser, "Ready for motion commands", READY_TIMEOUT)
+            if FAST_BAUD and FAST_BAUD != baud:
+                negotiate_baud(ser, name, baud, FAST_BAUD)
+            set_idle_rest(ser, name)
             return ser
         else:
             print(f"[MOTION_IO] ⚠ {name} port opened but not configured: {port}")
@@ -88,6 +187,201 @@ def get_arms_for_script(script):
         return True, True
     return send_to_left, send_to_right
 
+def ack_budget(script):
+    """Seconds to wait for a script's ACK before giving up on it."""
+    if not TIMED_PLAYBACK:
+        return ACK_TIMEOUT
+    try:
+        duration = float(script.get("duration", ACK_TIMEOUT))
+    except (TypeError, ValueError):
+        return ACK_TIMEOUT
+    return duration + TIMED_ACK_MARGIN
+
+def to_wire_script(script):
+    """Shallow copy of a script in the shape the firmware parses (keyframes as a list, timing mode set)."""
+    wire = dict(script)
+    if isinstance(wire.get("keyframes"), dict):
+        wire["keyframes"] = list(wire["keyframes"].values())
+    if TIMED_PLAYBACK:
+        wire.setdefault("timing", "timed")
+    return wire
+
+def json_default(obj):
+    if isinstance(obj, ObjectId):
+        return str(obj)
+    raise TypeError(f"Type {type(obj)} not serializable")
+
+def load_trajectory(script):
+    """
+    Per-arm stream frames compiled for script (see TRAJECTORY_DIR), or None
+    when there is no up-to-date .traj file for it.
+    """
+    token = script.get("token")
+    if not TRAJECTORY_DIR or not token:
+        return None
+    path = os.path.join(TRAJECTORY_DIR, f"{token}.traj")
+    try:
+        with open(path, "rb") as f:
+            digest, _rate, frames_by_side = unpack_trajectory(f.read())
+    except FileNotFoundError:
+        return None
+    except (OSError, ValueError) as e:
+        print(f"[MOTION_IO] ⚠ Ignoring trajectory {path}: {e}")
+        return None
+    if digest != script_digest(script):
+        print(f"[MOTION_IO] ⚠ Trajectory for '{token}' is stale; recompile it. Sending keyframes.")
+        return None
+    return frames_by_side
+
+def compile_plan(script):
+    """
+    Everything motion_io derives from a script before sending it, done once per
+    script (see PLAN_CACHE): the arms it drives, its ACK budget, and per arm the
+    wire bytes with seq 0, so a send only stamps in the seq. Binary plans hold
+    "frame" (also the sign cache key) or "stream"; JSON plans hold "json", the
+    projected line without its closing brace. "rejected" is why the safety
+    precheck refused the script (only with PRECHECK_REFUSES), or None.
+    """
+    wire = to_wire_script(script)
+    plan = {"arms": get_arms_for_script(script), "budget": ack_budget(script), "rejected": None}
+    if SAFETY_PRECHECK:
+        verdict = VERDICT_CACHE.get(script, precheck_script)
+        if not verdict.passed and PRECHECK_REFUSES:
+            plan["rejected"] = verdict.reason
+        elif not verdict.passed:
+            print(f"[MOTION_IO] ⚠ Precheck failed for '{script.get('token', '?')}' "
+                  f"(sending anyway, the controllers clamp): {verdict.reason}")
+    for side in ("left", "right"):
+        if WIRE_FORMAT != "binary":
+            line = json.dumps(project_script(wire, side), default=json_default, separators=(",", ":"))
+            plan[side] = {"json": line[:-1]}
+        elif needs_stream(wire):
+            plan[side] = {"stream": encode_stream_frames(wire, side)}
+        else:
+            plan[side] = {"frame": encode_motion_frame(wire, side)}
+
+    trajectory = load_trajectory(script) if WIRE_FORMAT == "binary" else None
+    for side, frames in (trajectory or {}).items():
+        # Sampled playback may run past the script's duration while joints settle
+        plan[side] = {"stream": frames}
+        plan["budget"] = max(plan["budget"], stream_duration(frames[0]) + TIMED_ACK_MARGIN)
+    return plan
+
+def plan_for(script):
+    """Compiled plan of a script, from PLAN_CACHE after the first time."""
+    return PLAN_CACHE.get(script, compile_plan)
+
+def wait_for_line(ser, text, timeout):
+    """Read lines until one contains text or timeout elapses. Returns the line or None."""
+    deadline = time.time() + timeout
+    while time.time() < deadline:
+        try:
+            if ser.in_waiting > 0:
+                line = ser.readline().decode(errors="ignore").strip()
+                if text in line:
+                    return line
+            else:
+                time.sleep(0.01)
+        except (OSError, serial.SerialException):
+            return None
+    return None
+
+def confirm_link(ser, tries):
+    """PING the controller at the port's current rate; True once a PONG comes back."""
+    for _ in range(tries):
+        try:
+            ser.reset_input_buffer()
+            ser.write(b"!PING 0\n")
+            ser.flush()
+        except (OSError, serial.SerialException):
+            return False
+        if wait_for_line(ser, "PONG 0 ", BAUD_CONFIRM_TIMEOUT):
+            return True
+    return False
+
+def negotiate_baud(ser, name, boot_baud, fast_baud):
+    """
+    Move an open controller link from boot_baud to fast_baud (see FAST_BAUD).
+    Returns the rate the link ended up at.
+    """
+    try:
+        ser.write(f"!BAUD {fast_baud}\n".encode("ascii"))
+        ser.flush()
+    except (OSError, serial.SerialException):
+        return boot_baud
+    if wait_for_line(ser, "BAUD ", BAUD_CONFIRM_TIMEOUT * BAUD_CONFIRM_TRIES) != f"BAUD {fast_baud}":
+        print(f"[MOTION_IO] ⚠ {name} controller refused {fast_baud} baud; staying at {boot_baud}.")
+        return boot_baud
+
+    try:
+        ser.baudrate = fast_baud
+        if confirm_link(ser, BAUD_CONFIRM_TRIES):
+            print(f"[MOTION_IO] ✓ {name} link at {fast_baud} baud")
+            return fast_baud
+        ser.baudrate = boot_baud
+    except (ValueError, OSError, serial.SerialException):
+        # The host side can't do the rate; the firmware reverts once no PING arrives
+        try:
+            ser.baudrate = boot_baud
+        except (ValueError, OSError, serial.SerialException):
+            return boot_baud
+    time.sleep(BAUD_REVERT_WAIT)
+    ok = confirm_link(ser, BAUD_CONFIRM_TRIES)
+    print(f"[MOTION_IO] ⚠ {name} link failed at {fast_baud} baud; back to {boot_baud}"
+          + ("." if ok else " (no PONG yet)."))
+    return boot_baud
+
+def set_idle_rest(ser, name):
+    """Set the controller's idle rest timeout to IDLE_REST (off when None)."""
+    ms = round(IDLE_REST * 1000) if IDLE_REST else 0
+    try:
+        ser.write(f"!IDLE {ms}\n".encode("ascii"))
+        ser.flush()
+    except (OSError, serial.SerialException):
+        return
+    if wait_for_line(ser, "IDLE ", STORE_TIMEOUT) != f"IDLE {ms}":
+        print(f"[MOTION_IO] ⚠ {name} controller did not confirm its idle rest timeout.")
+
+def upload_sign_cache(ser, name, side, encode):
+    """
+    Upload the fingerspelling letters for one arm into its controller's sign cache.
+    encode(script, side) gives the motion frame a script would otherwise be sent as,
+    or None when it goes out another way (e.g. as a trajectory stream) and so never
+    plays from the cache; returns {motion frame: cache id} for every entry the
+    controller confirmed, including the baked-in rest pose.
+    """
+    rest = REST_LEFT if side == "left" else REST_RIGHT
+    rest_frame = encode(rest, side)
+    cache = {} if rest_frame is None else {rest_frame: SIGN_ID_REST}
+    if not is_serial_valid(ser):
+        return cache
+
+    prefix = "L" if side == "left" else "R"
+    sign_id = SIGN_ID_REST + 1
+    for letter in sorted(FINGERSPELL_CACHE):
+        script = FINGERSPELL_CACHE[letter]
+        if not any(prefix in frame for frame in script.get("keyframes") or []):
+            continue  # nothing for this arm
+        frame = encode(script, side)
+        if frame is None:
+            continue  # streamed, so a cached copy would never be played
+        if frame in cache:
+            continue  # identical motion already uploaded
+        if sign_id >= SIGN_CACHE_SIZE:
+            break
+        try:
+            ser.write(encode_store_frame(to_wire_script(script), side, sign_id))
+            ser.flush()
+        except (serial.SerialException, OSError) as e:
+            print(f"[MOTION_IO] ⚠ Sign cache upload to {name} failed: {e}")
+            break
+        if wait_for_line(ser, f"STORED {sign_id}", STORE_TIMEOUT) == f"STORED {sign_id}":
+            cache[frame] = sign_id
+        sign_id += 1
+
+    print(f"[MOTION_IO] Cached {len(cache) - (rest_frame is not None)} signs on {name} controller.")
+    return cache
+
 def run_motion(file_io, emotion_gui_queue=None, left_port="COM8", right_port="COM4", baud=115200):
     # Connect to both controllers
     ser_left = connect_serial(left_port, baud, "LEFT")
@@ -99,10 +393,45 @@ def run_motion(file_io, emotion_gui_queue=None, left_port="COM8", right_port="CO
         print(f"  - LEFT port: {left_port}")
         print(f"  - RIGHT port: {right_port}")
 
-    def json_default(obj):
-        if isinstance(obj, ObjectId):
-            return str(obj)
-        raise TypeError(f"Type {type(obj)} not serializable")
+    def encode_frame(script, side):
+        # None for a script streamed from its .traj file (see compile_plan)
+        return plan_for(script)[side].get("frame")
+
+    # Per-arm {motion frame: cache id} for scripts resident on the controller
+    sign_cache = {"left": {}, "right": {}}
+
+    def refresh_sign_cache(ser, name, side):
+        if WIRE_FORMAT == "binary" and DEVICE_SIGN_CACHE and ser is not None:
+            sign_cache[side] = upload_sign_cache(ser, name, side, encode_frame)
+        else:
+            sign_cache[side] = {}
+
+    def encode_payload(script, side, seq=0, sync=False):
+        """
+        Wire bytes of one script for one controller ("left"/"right"), per WIRE_FORMAT.
+        Long scripts come back as a list of stream frames instead (see STREAM_WINDOW).
+        """
+        compiled = plan_for(script)[side]
+        if "stream" in compiled:
+            frames = compiled["stream"]
+            return [with_seq(frames[0], seq, sync)] + frames[1:]
+        if "frame" in compiled:
+            sign_id = None if sync else sign_cache[side].get(compiled["frame"])
+            if sign_id is not None:
+                return encode_play_frame(sign_id, seq)
+            return with_seq(compiled["frame"], seq, sync)
+        # seq in front of the JSON, so even a line that fails to parse is REJECTED by number
+        line = f"{seq} " + compiled["json"] + (',"sync":true' if sync else "")
+        return (line + "}\n").encode("utf-8")
+
+    # Plans depend on WIRE_FORMAT and TIMED_PLAYBACK, so every run starts clean.
+    # The scripts every session plays compile up front; DB signs on first use.
+    PLAN_CACHE.invalidate()
+    for script in [REST_LEFT, REST_RIGHT] + list(FINGERSPELL_CACHE.values()):
+        plan_for(script)
+
+    refresh_sign_cache(ser_left, "LEFT", "left")
+    refresh_sign_cache(ser_right, "RIGHT", "right")
 
     print("[MOTION_IO] Started motion execution loop.")
 
@@ -113,49 +442,284 @@ def run_motion(file_io, emotion_gui_queue=None, left_port="COM8", right_port="CO
 
     ack_received_left = threading.Event()
     ack_received_right = threading.Event()
+    events = {"LEFT": ack_received_left, "RIGHT": ack_received_right}
+
+    # Controller output: one reader thread per port blocks in readline() and
+    # queues (name, ser, line); this thread handles the lines, so a DONE wakes
+    # a waiting send at once and all writes stay on this thread. None only wakes
+    # it, for a cancel (FileIOManager.cancel_motion) or a port its reader lost.
+    messages = queue.Queue()
+    file_io.motion_wake = lambda: messages.put(None)
 
     last_active_arm = None  # None, "both", "left", "right"
 
-    def read_arduino_messages(ser, name, ack_event=None):
-        """Non-blocking read of Arduino output. Sets ack_event when ACK is received."""
+    # Stream chunks not yet sent, per controller name
+    stream_backlog = {"LEFT": [], "RIGHT": []}
+
+    def new_window():
+        """
+        Send-side state of one controller. in_flight maps seq -> [payload, deadline, token]
+        in send order for every command not yet reported DONE.
+        """
+        return {"next_seq": 1, "last_seq": 0, "in_flight": {}, "credits": MAX_QUEUE}
+
+    windows = {"LEFT": new_window(), "RIGHT": new_window()}
+
+    def new_clock():
+        """Clock estimate of one controller: recent (rtt, offset) PONG samples, offset = device ms - host ms."""
+        return {"samples": [], "ping_id": 0, "ping_sent": None, "last_ping": 0.0}
+
+    clocks = {"LEFT": new_clock(), "RIGHT": new_clock()}
+    ports = {"LEFT": None, "RIGHT": None}  # latest serial per controller, for GO and its reader
+    # Two-handed signs held on both arms ({"LEFT": seq, "RIGHT": seq}) and each arm's latest READY
+    sync_groups = []
+    sync_ready = {"LEFT": None, "RIGHT": None}
+
+    # Per controller: last seq that had been sent when stats were requested, and when
+    stats_polls = {"LEFT": {"seq": 0, "at": 0.0}, "RIGHT": {"seq": 0, "at": 0.0}}
+
+    def poll_stats(ser, name):
+        """Send "!STATS" every STATS_INTERVAL, but only if commands ran since the last one."""
+        poll = stats_polls[name]
+        now = time.monotonic()
+        last_seq = windows[name]["last_seq"]
+        if not STATS_INTERVAL or now - poll["at"] < STATS_INTERVAL or last_seq == poll["seq"]:
+            return
+        poll["seq"], poll["at"] = last_seq, now
+        ser.write(b"!STATS\n")
+        ser.flush()
+
+    def clock_offset(name):
+        samples = clocks[name]["samples"]
+        return min(samples)[1] if samples else None
+
+    def ping(ser, name):
+        """Send "!PING <n>" every SYNC_PING_INTERVAL; the PONG refreshes the clock offset."""
+        clock = clocks[name]
+        now = time.monotonic()
+        if now - clock["last_ping"] < SYNC_PING_INTERVAL:
+            return
+        clock["last_ping"] = now
+        clock["ping_id"] = clock["ping_id"] % 9999 + 1
+        clock["ping_sent"] = now
+        ser.write(f"!PING {clock['ping_id']}\n".encode("ascii"))
+        ser.flush()
+
+    def on_pong(name, ping_id, device_ms):
+        clock = clocks[name]
+        received = time.monotonic()
+        if ping_id != clock["ping_id"] or clock["ping_sent"] is None:
+            return  # reply to an older ping
+        sent, clock["ping_sent"] = clock["ping_sent"], None
+        # The device read its clock halfway through the round trip, give or take
+        offset = device_ms - (sent + received) * 500.0
+        clock["samples"] = (clock["samples"] + [(received - sent, offset)])[-SYNC_PING_SAMPLES:]
+
+    def clocks_ready(timeout):
+        """True once both arms have a clock offset, waiting up to timeout for PONGs still on their way."""
+        deadline = time.monotonic() + timeout
+        while clock_offset("LEFT") is None or clock_offset("RIGHT") is None:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0:
+                return False
+            read_arduino_messages(remaining)
+        return True
+
+    def release_synced():
+        """Send GO to both arms once both are holding the same two-handed sign."""
+        for group in list(sync_groups):
+            if any(sync_ready[name] != seq for name, seq in group.items()):
+                continue
+            sync_groups.remove(group)
+            go_at = (time.monotonic() + SYNC_GO_LEAD) * 1000.0
+            for name, seq in group.items():
+                ser, offset = ports[name], clock_offset(name)
+                if offset is None or not is_serial_valid(ser):
+                    continue  # that arm starts on its own after its sync timeout
+                try:
+                    ser.write(f"!GO {seq} {int(go_at + offset) & 0xFFFFFFFF}\n".encode("ascii"))
+                    ser.flush()
+                except (serial.SerialException, OSError):
+                    pass
+
+    def finish_through(window, seq):
+        """Drop in-flight commands up to and including seq (the controller runs them in order)."""
+        in_flight = window["in_flight"]
+        if seq not in in_flight:
+            return
+        while in_flight:
+            done = next(iter(in_flight))
+            del in_flight[done]
+            if done == seq:
+                break
+
+    def start_reader(ser, name):
+        """Read one controller's lines on a daemon thread until the port closes or is replaced."""
         if not is_serial_valid(ser):
             return
+        ports[name] = ser
+
+        def reader():
+            while not file_io.shutdown.is_set() and ports[name] is ser:
+                try:
+                    raw = ser.readline()  # blocks up to the port timeout
+                except Exception:
+                    # Closed or unplugged: close it so is_serial_valid fails, and wake
+                    # the motion thread so a wait on this controller ends now
+                    try:
+                        ser.close()
+                    except Exception:
+                        pass
+                    messages.put(None)
+                    return
+                if raw:
+                    messages.put((name, ser, raw.decode(errors="ignore").strip()))
+
+        threading.Thread(target=reader, name=f"motion-{name.lower()}-reader", daemon=True).start()
+
+    def read_arduino_messages(timeout=0.0):
+        """
+        Handle the controller lines the readers have queued, waiting up to timeout for
+        the first one, and send the periodic PING / STATS requests.
+        """
+        for name, ser in ports.items():
+            if not is_serial_valid(ser):
+                continue
+            try:
+                if SYNC_START:
+                    ping(ser, name)
+                poll_stats(ser, name)
+            except (OSError, serial.SerialException):
+                pass
+        try:
+            item = messages.get(timeout=timeout) if timeout > 0 else messages.get_nowait()
+        except queue.Empty:
+            return
+        while True:
+            if item is not None:
+                handle_message(*item)
+            try:
+                item = messages.get_nowait()
+            except queue.Empty:
+                return
+
+    def handle_message(name, ser, line):
+        """
+        One line of controller output. Tracks STARTED/DONE/REJECTED and credits in the
+        controller's window and sets its ack event when a command finishes, stops sending
+        on BUSY, and sends the next stream chunk on NEXT.
+        """
+        if ser is not ports[name] or not is_serial_valid(ser):
+            return  # from a port that has since been replaced
+        window = windows[name]
+        ack_event = events[name]
+        fields = line.split()
         try:
-            while ser.in_waiting > 0:
-                line = ser.readline().decode(errors="ignore").strip()
-                if line and line == "ACK" and ack_event is not None:
-                    ack_event.set()
-        except (OSError, serial.SerialException, Exception):
+            if len(fields) >= 2 and fields[0] in ("STARTED", "DONE", "REJECTED") and fields[1].isdigit():
+                seq = int(fields[1])
+                if len(fields) >= 3 and fields[2].isdigit():
+                    window["credits"] = int(fields[2])
+                entry = window["in_flight"].get(seq)
+                if fields[0] == "STARTED":
+                    if entry is not None:
+                        print(f"[EXEC] {name} controller executing {entry[2]}.")
+                    # Started without a GO (sync timeout): stop waiting for the pair
+                    sync_groups[:] = [g for g in sync_groups if g.get(name) != seq]
+                    return
+                if fields[0] == "REJECTED" and entry is not None:
+                    print(f"[MOTION_IO] ⚠ {name} controller rejected {entry[2]}.")
+                finish_through(window, seq)
+                ack_event.set()
+            elif line == "ACK":
+                # Seq-less command (e.g. sent by hand): it finished the oldest one
+                if window["in_flight"]:
+                    del window["in_flight"][next(iter(window["in_flight"]))]
+                ack_event.set()
+            elif len(fields) == 2 and fields[0] in ("CREDITS", "STOPPED", "FLUSHED", "RESTING") and fields[1].isdigit():
+                window["credits"] = int(fields[1])
+            elif len(fields) == 2 and fields[0] == "READY" and fields[1].isdigit():
+                sync_ready[name] = int(fields[1])
+                release_synced()
+            elif len(fields) == 3 and fields[0] == "PONG" and fields[1].isdigit() and fields[2].isdigit():
+                on_pong(name, int(fields[1]), int(fields[2]))
+            elif fields and fields[0] == "STATS":
+                print(f"[MOTION_IO] {name} controller stats: {line[len('STATS '):]}")
+            elif line == "BUSY":
+                # BUSY carries no seq, so which frame was dropped is unknown: send nothing
+                # more until a STARTED/DONE reports credits again. The dropped command is
+                # cleared by the next DONE past it, or times out in wait_for_window.
+                window["credits"] = 0
+                print(f"[MOTION_IO] ⚠ {name} controller queue was full, a command was dropped.")
+            elif line == "NEXT" and stream_backlog.get(name):
+                ser.write(stream_backlog[name].pop(0))
+                ser.flush()
+                window["credits"] -= 1
+        except (OSError, serial.SerialException):
             pass
 
-    def wait_ack_then_send(ser, name, payload_bytes, ack_event, pending_ref, other_ser, other_name, other_ack_event, timeout_msg=None):
-        """Wait for previous ACK if needed, send payload, drain. Returns (sent: bool, connection_lost: bool)."""
-        if not is_serial_valid(ser):
-            return (False, False)
-        if pending_ref[0]:
-            wait_start = time.time()
-            while pending_ref[0] and not file_io.shutdown.is_set():
-                read_arduino_messages(ser, name, ack_event)
-                read_arduino_messages(other_ser, other_name, other_ack_event)
-                if ack_event.is_set():
-                    ack_event.clear()
-                    pending_ref[0] = False
-                    break
-                if time.time() - wait_start > ACK_TIMEOUT:
+    def write_frames(ser, name, window, payload_bytes):
+        """Write payload and charge its frames against the controller's credits."""
+        frames = payload_bytes if isinstance(payload_bytes, list) else [payload_bytes]
+        ser.write(b"".join(frames))
+        ser.flush()
+        window["credits"] -= len(frames)
+
+    def wait_for_window(ser, name, ack_event, window, limit, timeout_msg=None):
+        """
+        Handle both controllers' lines until fewer than limit commands are in flight on this one
+        and it has a free command slot (limit 0 waits for all of them to finish).
+        Commands past their deadline are given up on, including one the controller
+        dropped with BUSY. Returns connection_lost: True as soon as the port goes
+        invalid, which the reader thread causes when the controller is unplugged.
+        """
+        in_flight = window["in_flight"]
+        while in_flight and not file_io.shutdown.is_set() and file_io.motion_cancel_queue.empty():
+            if not is_serial_valid(ser):
+                return True
+            # A sign never starts while this controller's stream still has chunks to send
+            if len(in_flight) < limit and window["credits"] > 0 and not stream_backlog[name]:
+                break
+            # Sleep until a line arrives from either controller, or briefly for the pings
+            oldest = next(iter(in_flight))
+            read_arduino_messages(min(WAIT_SLICE, max(0.0, in_flight[oldest][1] - time.time())))
+            ack_event.clear()
+            if in_flight:
+                oldest = next(iter(in_flight))
+                if time.time() > in_flight[oldest][1]:
                     if timeout_msg:
                         print(timeout_msg)
-                    ack_event.clear()
-                    pending_ref[0] = False
-                    break
-                time.sleep(0.01)
-        if file_io.shutdown.is_set():
-            return (False, False)
+                    del in_flight[oldest]
+        return False
+
+    def wait_ack_then_send(ser, name, script, side, ack_event, window, timeout_msg=None, ack_timeout=ACK_TIMEOUT, sync=False):
+        """
+        Wait for room in the controller's window, then send script with the next sequence number.
+        Returns (sent: bool, connection_lost: bool). ack_timeout is how long the script runs
+        for once the commands ahead of it are done. A stream sends its header and the first
+        STREAM_WINDOW chunks now, the rest on each NEXT. sync holds it for a synchronized
+        start; window["last_seq"] is the seq it went out with.
+        """
+        if not is_serial_valid(ser):
+            return (False, ser is not None)  # a port the reader closed is lost too
+        if wait_for_window(ser, name, ack_event, window, MOTION_WINDOW, timeout_msg):
+            return (False, True)
+        if file_io.shutdown.is_set() or not file_io.motion_cancel_queue.empty():
+            return (False, False)  # a cancel drops the script this was about to send
+
+        seq = window["next_seq"]
+        window["next_seq"] = seq % 255 + 1  # 1..255; 0 means "no seq, plain ACK"
+        window["last_seq"] = seq
+        payload_bytes = encode_payload(script, side, seq, sync)
+        if isinstance(payload_bytes, list):
+            stream_backlog[name] = payload_bytes[STREAM_WINDOW + 1:]
+            payload_bytes = payload_bytes[:STREAM_WINDOW + 1]
+        else:
+            stream_backlog[name] = []
         try:
-            ser.write(payload_bytes)
-            ser.flush()
-            pending_ref[0] = True
-            time.sleep(0.05)
-            read_arduino_messages(ser, name, ack_event)
+            write_frames(ser, name, window, payload_bytes)
+            # Deadline counts from when the commands already queued ahead of it should end
+            start = max([time.time()] + [entry[1] for entry in window["in_flight"].values()])
+            window["in_flight"][seq] = [payload_bytes, start + ack_timeout, script.get("token", "?")]
             return (True, False)
         except (serial.SerialException, OSError) as e:
             print(f"[ERROR] Failed to send to {name} controller: {e}")
@@ -165,16 +729,53 @@ def run_motion(file_io, emotion_gui_queue=None, left_port="COM8", right_port="CO
                 pass
             return (False, True)
 
-    pending_left = [False]
-    pending_right = [False]
+    def drain(ser, name, ack_event):
+        """Wait for every command in flight on one controller; returns connection_lost."""
+        if not is_serial_valid(ser):
+            return ser is not None  # a port the reader closed is lost too
+        return wait_for_window(ser, name, ack_event, windows[name], 0,
+                               f"[MOTION_IO] ⚠ ACK timeout from {name} controller (continuing anyway).")
+
+    def cancel_motion(command):
+        """
+        Send a priority command ("STOP", "FLUSH" or "REST"; see PRIORITY COMMANDS in
+        arm_controller.cpp) to both controllers and forget every command they had in flight.
+        """
+        nonlocal last_active_arm
+        for name in ("LEFT", "RIGHT"):
+            ser = ports[name]
+            if is_serial_valid(ser):
+                try:
+                    ser.write(f"!{command}\n".encode("ascii"))
+                    ser.flush()
+                except (serial.SerialException, OSError):
+                    pass
+            windows[name]["in_flight"].clear()
+            stream_backlog[name] = []
+            sync_ready[name] = None
+        sync_groups.clear()
+        last_active_arm = None
+        print(f"[MOTION_IO] Cancelled queued motion ({command}).")
+
+    start_reader(ser_left, "LEFT")
+    start_reader(ser_right, "RIGHT")
 
     while not file_io.shutdown.is_set():
-        # Check for Arduino messages periodically (non-blocking)
-        read_arduino_messages(ser_left, "LEFT", ack_received_left)
-        read_arduino_messages(ser_right, "RIGHT", ack_received_right)
+        # Priority commands go out before anything else (see FileIOManager.cancel_motion)
+        if not file_io.motion_cancel_queue.empty():
+            while not file_io.motion_cancel_queue.empty():
+                cancel_motion(file_io.motion_cancel_queue.get())
+            if file_io.motion_queue.empty():
+                file_io.motion_new_signal.clear()
+
+        # Handle controller lines. While a two-handed sign waits for both arms'
+        # READY or a stream still has chunks to send, block on them instead, so
+        # GO or the next chunk goes out the moment its reply lands
+        replies_due = sync_groups or stream_backlog["LEFT"] or stream_backlog["RIGHT"]
+        read_arduino_messages(WAIT_SLICE / 10 if replies_due else 0.0)
 
         # Wait for motion work (timeout so we can check shutdown)
-        if not file_io.motion_new_signal.wait(timeout=0.1):
+        if not file_io.motion_new_signal.wait(timeout=0.0 if replies_due else WAIT_SLICE):
             continue
 
         # Pop all motion scripts from the queue (skip if shutting down)
@@ -183,14 +784,14 @@ def run_motion(file_io, emotion_gui_queue=None, left_port="COM8", right_port="CO
             if emotion_gui_queue is not None and not file_io.motion_emotion_queue.empty():
                 emotion = file_io.pop_motion_emotion()
                 emotion_gui_queue.put(emotion)
-            # Ensure keyframes is always an array for Arduino parsing
-            if isinstance(script.get("keyframes"), dict):
-                script["keyframes"] = list(script["keyframes"].values())
-            payload = json.dumps(script, default=json_default) + "\n"
-            payload_bytes = payload.encode("utf-8")
+            plan = plan_for(script)
+            if plan["rejected"]:
+                print(f"[MOTION_IO] ⚠ Not sending '{script.get('token', '?')}': {plan['rejected']}")
+                continue
+            budget = plan["budget"]
             current_time = time.time()
 
-            send_to_left, send_to_right = get_arms_for_script(script)
+            send_to_left, send_to_right = plan["arms"]
             token_display = script.get("token", "?")
             target = "BOTH" if (send_to_left and send_to_right) else ("LEFT" if send_to_left else "RIGHT")
             print(f"[MOTION_IO] Sending '{token_display}' to {target}.")
@@ -205,38 +806,58 @@ def run_motion(file_io, emotion_gui_queue=None, left_port="COM8", right_port="CO
             else:
                 current_active_arm = None
 
-            # Send rest to inactive arm when switching context (both→one arm or left↔right)
-            if last_active_arm is not None and current_active_arm is not None:
+            # Without IDLE_REST both arms finish what they have queued before the context
+            # changes, so the rest sent below lines up behind the other arm's signing.
+            # With it there is no rest to line up: moves into or out of "both" are
+            # ordered by SYNC_START, and only a direct left <-> right switch waits, on
+            # the arm being vacated, so the pipeline (and blending) survives the rest.
+            if current_active_arm != last_active_arm:
+                switch = (last_active_arm, current_active_arm)
+                if not IDLE_REST or switch == ("left", "right"):
+                    if drain(ser_left, "LEFT", ack_received_left):
+                        ser_left = None
+                        last_reconnect_left = current_time
+                if not IDLE_REST or switch == ("right", "left"):
+                    if drain(ser_right, "RIGHT", ack_received_right):
+                        ser_right = None
+                        last_reconnect_right = current_time
+
+            # Send rest to inactive arm when switching context (both→one arm or left↔right);
+            # with IDLE_REST the controller rests on its own once it has nothing to do
+            if not IDLE_REST and last_active_arm is not None and current_active_arm is not None:
                 if current_active_arm == "right" and last_active_arm in ("both", "left"):
-                    rest_script = dict(REST_LEFT)
-                    if isinstance(rest_script.get("keyframes"), dict):
-                        rest_script["keyframes"] = list(rest_script["keyframes"].values())
-                    rest_bytes = (json.dumps(rest_script, default=json_default) + "\n").encode("utf-8")
+                    rest_script = REST_LEFT
                     sent, _ = wait_ack_then_send(
-                        ser_left, "LEFT", rest_bytes, ack_received_left, pending_left,
-                        ser_right, "RIGHT", ack_received_right, timeout_msg=None
+                        ser_left, "LEFT", rest_script, "left", ack_received_left, windows["LEFT"],
+                        timeout_msg=None,
+                        ack_timeout=plan_for(rest_script)["budget"]
                     )
                     if sent:
                         print("[MOTION_IO] Sending LEFT arm to rest position.")
                 elif current_active_arm == "left" and last_active_arm in ("both", "right"):
-                    rest_script = dict(REST_RIGHT)
-                    if isinstance(rest_script.get("keyframes"), dict):
-                        rest_script["keyframes"] = list(rest_script["keyframes"].values())
-                    rest_bytes = (json.dumps(rest_script, default=json_default) + "\n").encode("utf-8")
+                    rest_script = REST_RIGHT
                     sent, _ = wait_ack_then_send(
-                        ser_right, "RIGHT", rest_bytes, ack_received_right, pending_right,
-                        ser_left, "LEFT", ack_received_left, timeout_msg=None
+                        ser_right, "RIGHT", rest_script, "right", ack_received_right, windows["RIGHT"],
+                        timeout_msg=None,
+                        ack_timeout=plan_for(rest_script)["budget"]
                     )
                     if sent:
                         print("[MOTION_IO] Sending RIGHT arm to rest position.")
 
+            # Two-handed signs are held on both arms and started together (see SYNC_START)
+            sync = (SYNC_START and send_to_left and send_to_right
+                    and is_serial_valid(ser_left) and is_serial_valid(ser_right)
+                    and clocks_ready(SYNC_CLOCK_WAIT))
+            sent_left = sent_right = False
+
             # Send main script to left controller
             if send_to_left:
                 sent, connection_lost = wait_ack_then_send(
-                    ser_left, "LEFT", payload_bytes, ack_received_left, pending_left,
-                    ser_right, "RIGHT", ack_received_right,
-                    timeout_msg=f"[MOTION_IO] ⚠ ACK timeout from LEFT controller after {ACK_TIMEOUT}s (continuing anyway)."
+                    ser_left, "LEFT", script, "left", ack_received_left, windows["LEFT"],
+                    timeout_msg="[MOTION_IO] ⚠ ACK timeout from LEFT controller (continuing anyway).",
+                    ack_timeout=budget, sync=sync
                 )
+                sent_left = sent
                 if connection_lost:
                     ser_left = None
                     last_reconnect_left = current_time
@@ -246,14 +867,20 @@ def run_motion(file_io, emotion_gui_queue=None, left_port="COM8", right_port="CO
                 ser_left = connect_serial(left_port, baud, "LEFT")
                 if ser_left is None:
                     last_reconnect_left = current_time
+                else:
+                    windows["LEFT"] = new_window()
+                    clocks["LEFT"] = new_clock()
+                    refresh_sign_cache(ser_left, "LEFT", "left")
+                    start_reader(ser_left, "LEFT")
 
             # Send main script to right controller
             if send_to_right:
                 sent, connection_lost = wait_ack_then_send(
-                    ser_right, "RIGHT", payload_bytes, ack_received_right, pending_right,
-                    ser_left, "LEFT", ack_received_left,
-                    timeout_msg=f"[MOTION_IO] ⚠ ACK timeout from RIGHT controller after {ACK_TIMEOUT}s (continuing anyway)."
+                    ser_right, "RIGHT", script, "right", ack_received_right, windows["RIGHT"],
+                    timeout_msg="[MOTION_IO] ⚠ ACK timeout from RIGHT controller (continuing anyway).",
+                    ack_timeout=budget, sync=sync
                 )
+                sent_right = sent
                 if connection_lost:
                     ser_right = None
                     last_reconnect_right = current_time
@@ -263,11 +890,21 @@ def run_motion(file_io, emotion_gui_queue=None, left_port="COM8", right_port="CO
                 ser_right = connect_serial(right_port, baud, "RIGHT")
                 if ser_right is None:
                     last_reconnect_right = current_time
+                else:
+                    windows["RIGHT"] = new_window()
+                    clocks["RIGHT"] = new_clock()
+                    refresh_sign_cache(ser_right, "RIGHT", "right")
+                    start_reader(ser_right, "RIGHT")
+
+            if sync and sent_left and sent_right:
+                sync_groups.append({"LEFT": windows["LEFT"]["last_seq"], "RIGHT": windows["RIGHT"]["last_seq"]})
+                release_synced()  # both READYs may already be in
 
             last_active_arm = current_active_arm
 
-            # Inter-motion delay: shorter for letters, longer for full signs
-            if not file_io.motion_queue.empty():
+            # Inter-motion delay: shorter for letters, longer for full signs. With a
+            # window the next sign is already queued on the controller instead.
+            if MOTION_WINDOW == 1 and not file_io.motion_queue.empty():
                 delay_s = FINGERSPELL_POST_DELAY if len(script.get("token", "")) == 1 else SIGN_POST_DELAY
                 time.sleep(delay_s)
 
@@ -275,8 +912,6 @@ def run_motion(file_io, emotion_gui_queue=None, left_port="COM8", right_port="CO
             if file_io.motion_queue.empty():
                 file_io.motion_new_signal.clear()
 
-        time.sleep(0.01)
-
     # Shutdown: close serial ports
     for ser, name in [(ser_left, "LEFT"), (ser_right, "RIGHT")]:
         if ser is not None and is_serial_valid(ser):
@@ -2,13 +2,104 @@
 
 from __future__ import annotations
 
+import threading
+import time
+
 from src.cache.fingerspelling_cache import get_letter_motion
-from src.database.db_functions import get_sign_by_token
+from src.cache.plan_cache import PLAN_CACHE
+from src.database.db_functions import get_sign_by_token, get_signs_by_tokens
+
+# DB documents by token (None = not in the DB), least recently used first. A
+# repeated token skips the round trip and hands motion_io the same document
+# object, so its compiled plan is reused too. Entries are re-fetched after
+# SIGN_REFRESH_INTERVAL, which picks up a reseed from another process;
+# refresh_signs() drops them at once.
+SIGN_REFRESH_INTERVAL = 300.0  # s
+SIGN_CACHE_SIZE = 256  # tokens; room for the whole seeded library + misses
+
+# Loaded by warm_signs() at startup so the first sentences skip the DB
+COMMON_SIGNS = (
+    "HELLO", "GOODBYE", "THANKS", "PLEASE", "SORRY", "YES", "NO", "ME", "YOU",
+    "NAME", "FRIEND", "GOOD", "FINE", "HELP", "LOVE", "WHAT", "WHERE", "WHO",
+    "WHEN", "WHY", "HOW", "MORE", "AGAIN", "NOW", "TODAY", "WAIT", "STOP",
+    "GO", "COME", "KNOW", "UNDERSTAND", "WANT", "LIKE", "NEED", "HAPPY",
+)
+
+_sign_docs: dict = {}  # upper-cased token -> (fetched at, document or None)
+_sign_docs_lock = threading.Lock()
+
+
+def _cached(key: str, now: float):
+    """(True, document) for a fresh entry, marking it recently used; (False, None) otherwise."""
+    with _sign_docs_lock:
+        entry = _sign_docs.pop(key, None)
+        if entry is None or now - entry[0] >= SIGN_REFRESH_INTERVAL:
+            return False, None
+        _sign_docs[key] = entry
+        return True, entry[1]
+
+
+def _store(key: str, now: float, doc) -> None:
+    with _sign_docs_lock:
+        _sign_docs.pop(key, None)
+        while len(_sign_docs) >= SIGN_CACHE_SIZE:
+            del _sign_docs[next(iter(_sign_docs))]
+        _sign_docs[key] = (now, doc)
+
+
+def lookup_sign(token: str):
+    """DB document for token, from the cache while it is fresh."""
+    key = (token or "").upper()
+    now = time.monotonic()
+    hit, doc = _cached(key, now)
+    if hit:
+        return doc
+    doc = get_sign_by_token(token)
+    _store(key, now, doc)
+    return doc
+
+
+def resolve_signs(tokens) -> dict:
+    """
+    DB documents for a whole gloss sequence, keyed by upper-cased token. Every
+    token not cached (or stale) is fetched in one $in query, so the lookups
+    enqueue_motions_for_token makes for them afterwards are all cache hits.
+    """
+    now = time.monotonic()
+    docs: dict = {}
+    missing: list[str] = []
+    for token in tokens:
+        key = (token or "").upper()
+        if not key.strip() or key in docs or key in missing:
+            continue
+        hit, doc = _cached(key, now)
+        if hit:
+            docs[key] = doc
+        else:
+            missing.append(key)
+    if missing:
+        fetched = get_signs_by_tokens(missing)
+        for key in missing:
+            docs[key] = fetched.get(key)
+            _store(key, now, docs[key])
+    return docs
+
+
+def warm_signs(tokens=COMMON_SIGNS) -> int:
+    """Load the common signs into the cache; returns how many are in the DB."""
+    return sum(doc is not None for doc in resolve_signs(tokens).values())
+
+
+def refresh_signs() -> None:
+    """Forget every cached document and compiled plan, e.g. after the DB was reseeded."""
+    with _sign_docs_lock:
+        _sign_docs.clear()
+    PLAN_CACHE.invalidate()
 
 
 def motions_for_token(token: str) -> list[dict]:
     """Return motion documents for one token without queueing (for dry-run / inspection)."""
-    sign_data = get_sign_by_token(token)
+    sign_data = lookup_sign(token)
     if sign_data:
         return [sign_data]
     token_str = (token or "").strip()
@@ -28,14 +119,16 @@ def enqueue_motions_for_token(
     *,
     log: bool = True,
     log_tag: str = "[DB_IO]",
+    tag=None,
 ) -> int:
     """
     Push motion script(s) for one ASL token onto file_io.motion_queue.
+    tag is the token's FileIOManager tag, passed on with each script.
     Returns the number of scripts queued.
     """
-    sign_data = get_sign_by_token(token)
+    sign_data = lookup_sign(token)
     if sign_data:
-        file_io.push_motion_script(sign_data)
+        file_io.push_motion_script(sign_data, tag)
         if log:
             print(f"{log_tag} Retrieved sign for {token}")
         return 1
@@ -50,7 +143,7 @@ def enqueue_motions_for_token(
     for char in token_str.upper():
         motion = get_letter_motion(char)
         if motion:
-            file_io.push_motion_script(motion)
+            file_io.push_motion_script(motion, tag)
             queued += 1
             if log:
                 print(f"{log_tag} Queued letter '{char}' (fallback fingerspelling).")
@@ -0,0 +1,73 @@
+"""Speculative translation of an utterance from interim STT hypotheses (incremental mode)."""
+
+from __future__ import annotations
+
+import string
+
+# Translate the agreed prefix again once it has grown by this many words
+SPECULATE_MIN_WORDS = 1
+# Gloss tokens held back from the end of an agreed translation (a phrase merge could still take them)
+HOLDBACK_TOKENS = 0
+# translate_to_asl_gloss moves these to the end of the sentence, so they are never released early
+QUESTION_WORDS = {"WHO", "WHAT", "WHEN", "WHERE", "WHY", "HOW"}
+
+
+def common_prefix(a: list, b: list) -> list:
+    n = 0
+    for x, y in zip(a, b):
+        if x != y:
+            break
+        n += 1
+    return a[:n]
+
+
+def hypothesis_words(text: str) -> list[str]:
+    words = (w.strip(string.punctuation) for w in text.lower().split())
+    return [w for w in words if w]
+
+
+class SpeculativeUtterance:
+    """
+    One utterance while it is being spoken. Each interim hypothesis is cut down to the
+    words it shares with the previous one, minus the word still being spoken, and that
+    agreed prefix is translated. Gloss tokens two consecutive prefix translations agree
+    on are released ahead of the final transcript. The final translation then supplies
+    the rest of the sentence, or shows where the released tokens went wrong.
+    """
+
+    def __init__(self, utterance_id: int, translate):
+        self.id = utterance_id
+        self.translate = translate
+        self.words: list[str] = []     # latest hypothesis
+        self.agreed: list[str] = []    # words last translated
+        self.gloss: list[str] = []     # their translation
+        self.released: list[str] = []  # tokens handed on so far
+
+    def update(self, text: str) -> list[str]:
+        """Feed an interim hypothesis; returns the tokens it makes safe to release."""
+        words = hypothesis_words(text)
+        agreed = common_prefix(self.words, words[:-1])
+        self.words = words
+        if len(agreed) < len(self.agreed) + SPECULATE_MIN_WORDS:
+            return []
+
+        self.agreed = agreed
+        gloss = self.translate(" ".join(agreed))
+        stable = common_prefix(self.gloss, gloss)
+        self.gloss = gloss
+        stable = stable[:max(0, len(stable) - HOLDBACK_TOKENS)]
+        for i, token in enumerate(stable):
+            if token in QUESTION_WORDS:
+                stable = stable[:i]
+                break
+        if stable[:len(self.released)] != self.released:
+            return []  # the translation moved away from what was released; the final decides
+
+        new = stable[len(self.released):]
+        self.released += new
+        return new
+
+    def finish(self, text: str) -> tuple[list[str], int]:
+        """Translate the final transcript; returns (tokens, how many released tokens it starts with)."""
+        tokens = self.translate(text)
+        return tokens, len(common_prefix(self.released, tokens))
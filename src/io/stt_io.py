@@ -1,12 +1,29 @@
+import os
+
 from src.io.fileIO import FileIOManager
 from src.speech_to_text.stt_factory import create_stt
 
+# STT_INCREMENTAL=1: pass interim hypotheses on too, so ai_io can start translating
+# (and the arms signing) before the speaker finishes the sentence
+INCREMENTAL_STT = os.getenv("STT_INCREMENTAL", "").strip().lower() in ("1", "true", "yes", "on")
+
+# Stop phrases that also cut the signing short. The goodbye ("thank you fred")
+# is not one: the speaker's last sentence is usually still queued and finishes.
+CANCEL_PHRASES = ("stop moving", "fred stop")
+
 
 def run_stt(file_io: FileIOManager):
     stt = create_stt()
     try:
         stt.start_stream()
-        for line in stt.get_transcripts():
-            file_io.push_stt_line(line)
+        if INCREMENTAL_STT:
+            for text, final in stt.get_updates():
+                file_io.push_stt_update(text, final)
+        else:
+            for line in stt.get_transcripts():
+                file_io.push_stt_line(line)
+        # "stop moving" / "fred stop": drop what is still queued and bring the arms to rest now
+        if stt.stop_phrase in CANCEL_PHRASES:
+            file_io.cancel_motion("REST")
     finally:
-        stt.stop_stream()
\ No newline at end of file
+        stt.stop_stream()
@@ -0,0 +1,133 @@
+"""
+Tests for batched sign lookups between ai_io and db_io.
+
+Verifies:
+  1. A multi-token push is resolved with exactly one get_signs_by_tokens call.
+  2. Each token's scripts still reach the motion queue in order with their tags.
+  3. Tokens of an utterance retracted before the push are dropped as a batch.
+"""
+
+import importlib
+import sys
+import types
+
+import pytest
+
+from src.io.fileIO import FileIOManager
+
+
+# ---------------------------------------------------------------------------
+# Helpers — stub out the models and MongoDB so only the queueing is exercised
+# ---------------------------------------------------------------------------
+
+def _stub_module(monkeypatch, name: str, **attrs) -> None:
+    module = types.ModuleType(name)
+    module.__dict__.update(attrs)
+    monkeypatch.setitem(sys.modules, name, module)
+
+
+class _DatabaseConnection:
+    @classmethod
+    def initialize(cls):
+        pass
+
+
+@pytest.fixture
+def pipeline(monkeypatch):
+    """(ai_io, db_io, sign_resolution, file_io, recorded get_signs_by_tokens calls)."""
+    _stub_module(monkeypatch, "src.text_to_ASL.translate_AI",
+                 translate_to_asl_gloss=lambda text: [])
+    _stub_module(monkeypatch, "src.text_to_emotion.emotion_AI",
+                 translate_to_emotions=lambda text: ["neutral"])
+    _stub_module(monkeypatch, "src.database.db_connection",
+                 DatabaseConnection=_DatabaseConnection)
+    for name in ("src.database.db_functions", "src.io.sign_resolution",
+                 "src.io.db_io", "src.io.ai_io"):
+        monkeypatch.delitem(sys.modules, name, raising=False)
+
+    sign_resolution = importlib.import_module("src.io.sign_resolution")
+    db_io = importlib.import_module("src.io.db_io")
+    ai_io = importlib.import_module("src.io.ai_io")
+
+    calls = []
+
+    def get_signs_by_tokens(tokens):
+        calls.append(list(tokens))
+        return {t: {"token": t, "keyframes": []} for t in tokens if t != "ZZ"}
+
+    def get_sign_by_token(token):
+        raise AssertionError(f"single lookup for {token}; expected a batch hit")
+
+    monkeypatch.setattr(sign_resolution, "get_signs_by_tokens", get_signs_by_tokens)
+    monkeypatch.setattr(sign_resolution, "get_sign_by_token", get_sign_by_token)
+    sign_resolution.refresh_signs()
+
+    # db_io wakes on the first signal; run its drain right there, as it would
+    file_io = FileIOManager()
+    monkeypatch.setattr(file_io.asl_new_signal, "set",
+                        lambda: db_io.process_queued_tokens(file_io))
+    yield ai_io, db_io, sign_resolution, file_io, calls
+    sign_resolution.refresh_signs()
+
+
+def _drain_motions(file_io) -> list:
+    out = []
+    while not file_io.motion_queue.empty():
+        out.append(file_io.pop_motion_script())
+    return out
+
+
+# ---------------------------------------------------------------------------
+# Test 1 — one query per pushed sentence
+# ---------------------------------------------------------------------------
+
+class TestOneQueryPerPush:
+
+    def test_multi_token_push_makes_one_batched_call(self, pipeline):
+        ai_io, _, _, file_io, calls = pipeline
+        ai_io.push_tokens(file_io, "my name is what", ["MY", "NAME", "WHAT"])
+        assert calls == [["MY", "NAME", "WHAT"]]
+
+    def test_repeat_sentence_is_all_cache_hits(self, pipeline):
+        ai_io, _, _, file_io, calls = pipeline
+        ai_io.push_tokens(file_io, "my name", ["MY", "NAME"])
+        ai_io.push_tokens(file_io, "name my", ["NAME", "MY"])
+        assert calls == [["MY", "NAME"]]
+
+
+# ---------------------------------------------------------------------------
+# Test 2 — order and tags survive the batch
+# ---------------------------------------------------------------------------
+
+class TestBatchOrder:
+
+    def test_scripts_follow_token_order_with_tags(self, pipeline):
+        ai_io, _, _, file_io, calls = pipeline
+        ai_io.push_tokens(file_io, "hello friend", ["HELLO", "FRIEND"], utterance=7)
+        tagged = []
+        while not file_io.motion_queue.empty():
+            script, tag = file_io.motion_queue.get_nowait()
+            tagged.append((script["token"], tag))
+        assert tagged == [("HELLO", (7, 0)), ("FRIEND", (7, 1))]
+        assert len(calls) == 1
+
+    def test_unknown_token_is_fingerspelled_after_the_batch(self, pipeline):
+        ai_io, _, _, file_io, calls = pipeline
+        ai_io.push_tokens(file_io, "hello zz", ["HELLO", "ZZ"])
+        scripts = _drain_motions(file_io)
+        assert [s["token"] for s in scripts] == ["HELLO", "Z", "Z"]
+        assert calls == [["HELLO", "ZZ"]]
+
+
+# ---------------------------------------------------------------------------
+# Test 3 — retracted tokens never reach the DB
+# ---------------------------------------------------------------------------
+
+class TestRetractedBatch:
+
+    def test_retracted_utterance_pushes_nothing(self, pipeline):
+        ai_io, _, _, file_io, calls = pipeline
+        file_io.retract_tokens(3, 0)
+        ai_io.push_tokens(file_io, "hello friend", ["HELLO", "FRIEND"], utterance=3)
+        assert calls == []
+        assert file_io.asl_token_queue.empty()
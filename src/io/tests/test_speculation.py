@@ -0,0 +1,147 @@
+"""
+Tests for speculative signing: SpeculativeUtterance and the FileIOManager tag bookkeeping.
+
+Verifies:
+  1. A retraction drops queued tokens, scripts and emotions at or after the cut.
+  2. Tokens motion_io already took are kept, and the resume index points past them.
+  3. A finished utterance leaves no bookkeeping behind once its last item is consumed.
+  4. update/finish release agreed tokens and report where a revised final diverges.
+"""
+
+from src.io.fileIO import FileIOManager
+from src.io.speculation import SpeculativeUtterance
+
+
+# ---------------------------------------------------------------------------
+# Helpers
+# ---------------------------------------------------------------------------
+
+def _push_utterance(file_io, utterance: int, tokens: list) -> None:
+    """Queue each token with its script and emotion, tagged (utterance, index), as db_io/ai_io would."""
+    file_io.push_asl_tokens([(token, (utterance, i)) for i, token in enumerate(tokens)])
+    for i, token in enumerate(tokens):
+        file_io.push_motion_script({"token": token}, (utterance, i))
+        file_io.push_motion_emotion("neutral", (utterance, i))
+
+
+def _queued_tags(q) -> list:
+    return [tag for _, tag in q.queue]
+
+
+def _queued_token_tags(file_io) -> list:
+    return [tag for batch in file_io.asl_token_queue.queue for _, tag in batch]
+
+
+def _translate(text: str) -> list:
+    """One gloss token per word."""
+    return [word.upper() for word in text.split()]
+
+
+# ---------------------------------------------------------------------------
+# Test 1 — retraction drops everything from the cut on
+# ---------------------------------------------------------------------------
+
+class TestRetraction:
+
+    def test_retraction_drops_queued_items_from_the_cut(self):
+        file_io = FileIOManager()
+        _push_utterance(file_io, 1, ["MY", "NAME", "IS", "JOHN"])
+
+        assert file_io.retract_tokens(1, 2) == 2
+
+        kept = [(1, 0), (1, 1)]
+        assert _queued_token_tags(file_io) == kept
+        assert _queued_tags(file_io.motion_queue) == kept
+        assert _queued_tags(file_io.motion_emotion_queue) == kept
+        assert file_io.tagged[1] == 3 * len(kept)
+
+    def test_retracted_tokens_are_not_queued_again(self):
+        file_io = FileIOManager()
+        file_io.retract_tokens(1, 0)
+        file_io.push_motion_script({"token": "LATE"}, (1, 3))
+        assert file_io.motion_queue.empty()
+
+
+# ---------------------------------------------------------------------------
+# Test 2 — what motion_io already took stays
+# ---------------------------------------------------------------------------
+
+class TestTakenTokensStay:
+
+    def test_resume_index_points_past_taken_tokens(self):
+        file_io = FileIOManager()
+        _push_utterance(file_io, 1, ["MY", "NAME", "IS", "JOHN"])
+        taken = [file_io.pop_motion_script()["token"] for _ in range(2)]
+
+        # The final transcript disagrees from token 1 on, but MY and NAME are already signing
+        assert file_io.retract_tokens(1, 1) == 2
+
+        assert taken == ["MY", "NAME"]
+        assert _queued_tags(file_io.motion_queue) == []
+        assert _queued_tags(file_io.motion_emotion_queue) == [(1, 0), (1, 1)]
+
+
+# ---------------------------------------------------------------------------
+# Test 3 — a finished utterance is forgotten once consumed
+# ---------------------------------------------------------------------------
+
+class TestBookkeepingCleared:
+
+    def test_finished_utterance_leaves_nothing_behind(self):
+        file_io = FileIOManager()
+        _push_utterance(file_io, 1, ["MY", "NAME", "IS", "JOHN"])
+        file_io.pop_motion_script()
+        file_io.retract_tokens(1, 2)
+        file_io.finish_utterance(1)
+        assert 1 in file_io.tagged  # its kept items are still on the way
+
+        while not file_io.asl_token_queue.empty():
+            for _, tag in file_io.pop_asl_tokens():
+                file_io.release_tag(tag)
+        while not file_io.motion_queue.empty():
+            file_io.pop_motion_script()
+        while not file_io.motion_emotion_queue.empty():
+            file_io.pop_motion_emotion()
+
+        assert file_io.retracted == {}
+        assert file_io.tagged == {}
+        assert file_io.motion_progress == {}
+        assert file_io.finished == set()
+
+
+# ---------------------------------------------------------------------------
+# Test 4 — SpeculativeUtterance on a revised hypothesis
+# ---------------------------------------------------------------------------
+
+class TestSpeculativeUtterance:
+
+    def test_releases_tokens_two_translations_agree_on(self):
+        utterance = SpeculativeUtterance(1, _translate)
+        assert utterance.update("my name") == []         # no earlier hypothesis to agree with
+        assert utterance.update("my name is") == []      # first translation of "my name"
+        assert utterance.update("my name is john") == ["MY", "NAME"]
+        assert utterance.released == ["MY", "NAME"]
+
+    def test_revised_hypothesis_releases_nothing_more(self):
+        utterance = SpeculativeUtterance(1, _translate)
+        for text in ("my name", "my name is", "my name is john"):
+            utterance.update(text)
+
+        # The recognizer changes its mind about "name": the agreed prefix shrinks
+        assert utterance.update("my game is john") == []
+        assert utterance.released == ["MY", "NAME"]
+
+    def test_finish_reports_where_the_final_diverges(self):
+        utterance = SpeculativeUtterance(1, _translate)
+        for text in ("my name", "my name is", "my name is john"):
+            utterance.update(text)
+
+        assert utterance.finish("my name is john") == (["MY", "NAME", "IS", "JOHN"], 2)
+        assert utterance.finish("my game is john") == (["MY", "GAME", "IS", "JOHN"], 1)
+
+    def test_question_words_are_held_back(self):
+        utterance = SpeculativeUtterance(1, _translate)
+        for text in ("what is", "what is your", "what is your name"):
+            utterance.update(text)
+        # WHAT and IS were agreed twice, but the final moves WHAT to the end
+        assert utterance.released == []
@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+
+// ================================
+// ARM TRAITS
+// ================================
+// Everything that differs between the left and right controllers. The
+// firmware (src/arm_controller.cpp) is written once against `Arm`, and each
+// platformio.ini env picks the side with -DARM_LEFT or -DARM_RIGHT, so both
+// binaries come from the same source with their constants folded in.
+//
+// Only arm_controller.cpp includes this header, which is why the
+// out-of-line array definitions below (needed before C++17) can live here.
+// The host simulator (sim/sim_main.cpp) includes it too, but builds as C++17,
+// where they are only redeclarations.
+
+// Shared calibration: both arms use the same drivers and gearboxes
+struct ArmTraitsBase {
+  // Rotation axis — tune for actual gear ratio
+  static constexpr float rotationStepsPerDeg  = 320.0f;
+  // Elevation axis — 125:1 gearbox
+  // ACTION ITEM: 3200 * 125 / 360 is 1111.1, but 222.22 (the 25:1 figure) is
+  // what both arms have always run. Measure degrees per step on the arm and
+  // fix either this constant or the gearbox ratio.
+  static constexpr float elevationStepsPerDeg = 222.22f;
+
+  // Servo pins in joint-table order:
+  //   hand Thumb, Index, Middle, Ring, Pinky | wrist Rotation, Flexion | elbow
+  static constexpr uint8_t servoPins[8] = {2, 4, 5, 18, 19, 21, 22, 23};
+  // Pulse width (µs) at 0° and at 180° per channel; ESP32Servo's defaults
+  // until the servos are calibrated individually
+  static constexpr uint16_t servoMinUs[8] = {544, 544, 544, 544, 544, 544, 544, 544};
+  static constexpr uint16_t servoMaxUs[8] = {2400, 2400, 2400, 2400, 2400, 2400, 2400, 2400};
+  // Travel per channel (degrees), kept inside the hard stops so a bad
+  // keyframe can't stall a servo against one. Mirrored by
+  // CHANNEL_MIN_DEG / CHANNEL_MAX_DEG in src/fk_tool/config.py.
+  // ACTION ITEM: measure the stops on each arm.
+  static constexpr uint8_t servoMinDeg[8] = {0, 0, 0, 0, 0, 10, 10, 20};
+  static constexpr uint8_t servoMaxDeg[8] = {180, 180, 180, 180, 180, 170, 170, 160};
+  // Shoulder travel (degrees from the position the steppers power up in)
+  static constexpr float rotationMinDeg  = -45.0f;
+  static constexpr float rotationMaxDeg  = 45.0f;
+  static constexpr float elevationMinDeg = -30.0f;
+  static constexpr float elevationMaxDeg = 90.0f;
+
+  // Motor 1: Shoulder Rotation (internal/external rotation) — 36:1 gearbox
+  static constexpr uint8_t rotationStepPin   = 33;
+  static constexpr uint8_t rotationDirPin    = 32;
+  static constexpr uint8_t rotationEnablePin = 25;
+  // Motor 2: Shoulder Flexion/Elevation (raise/lower) — 125:1 gearbox
+  static constexpr uint8_t elevationStepPin   = 27;
+  static constexpr uint8_t elevationDirPin    = 26;
+  static constexpr uint8_t elevationEnablePin = 14;
+};
+
+constexpr uint8_t ArmTraitsBase::servoPins[];
+constexpr uint16_t ArmTraitsBase::servoMinUs[];
+constexpr uint16_t ArmTraitsBase::servoMaxUs[];
+constexpr uint8_t ArmTraitsBase::servoMinDeg[];
+constexpr uint8_t ArmTraitsBase::servoMaxDeg[];
+
+struct LeftArm : ArmTraitsBase {
+  // Keyframe keys in sign JSON (see COMMAND_FILTER_FORMAT)
+  static constexpr const char *handKey     = "L";
+  static constexpr const char *wristKey    = "LW";
+  static constexpr const char *elbowKey    = "LE";
+  static constexpr const char *shoulderKey = "LS";
+  static constexpr const char *restToken   = "REST_LEFT";  // REST_LEFT in rest_cache.py
+  // The left shoulder is mirrored: positive angles step the motors backwards
+  static constexpr int shoulderDirection = -1;
+};
+
+struct RightArm : ArmTraitsBase {
+  static constexpr const char *handKey     = "R";
+  static constexpr const char *wristKey    = "RW";
+  static constexpr const char *elbowKey    = "RE";
+  static constexpr const char *shoulderKey = "RS";
+  static constexpr const char *restToken   = "REST_RIGHT";  // REST_RIGHT in rest_cache.py
+  static constexpr int shoulderDirection = 1;
+};
+
+// ARM_TAG prefixes log lines; a macro so it joins the message literal
+#if defined(ARM_LEFT)
+using Arm = LeftArm;
+#define ARM_TAG "[LEFT_ARM] "
+#elif defined(ARM_RIGHT)
+using Arm = RightArm;
+#define ARM_TAG "[RIGHT_ARM] "
+#else
+#error "Build with -DARM_LEFT or -DARM_RIGHT (see platformio.ini)"
+#endif
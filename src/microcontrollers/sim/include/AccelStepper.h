@@ -0,0 +1,71 @@
+#pragma once
+#include <Arduino.h>
+
+// ================================
+// AccelStepper (SIMULATOR)
+// ================================
+// Used when the firmware is built with -DSHOULDER_STEP_TIMER=0. A
+// time-stepped trapezoidal profile with the AccelStepper calls the firmware
+// makes; steps go out as STEP/DIR pin writes like the real driver's, so the
+// simulator counts them the same way for both stepper backends.
+class AccelStepper {
+ public:
+  enum MotorInterfaceType { DRIVER = 1 };
+
+  AccelStepper(uint8_t, uint8_t stepPin, uint8_t dirPin) : stepPin(stepPin), dirPin(dirPin) {}
+
+  void setMaxSpeed(float stepsPerSec) { maxSpeed = fabsf(stepsPerSec); }
+  void setAcceleration(float stepsPerSec2) { accel = fabsf(stepsPerSec2); }
+  void moveTo(long position) { target = position; }
+  long distanceToGo() { return target - position; }
+  long currentPosition() { return position; }
+
+  // Come to rest from the current speed at the set acceleration
+  void stop() {
+    long stopping = (long)(speed * speed / (2.0f * accel));
+    target = position + (speed >= 0.0f ? stopping : -stopping);
+  }
+
+  // Take at most one step if one is due; true while moving
+  bool run() {
+    unsigned long now = micros();
+    float dt = (now - lastUs) / 1000000.0f;
+    lastUs = now;
+
+    long remaining = target - position;
+    if (remaining == 0 && speed == 0.0f) return false;
+
+    // Brake when the stopping distance v^2 / 2a reaches what is left
+    float stopping = speed * speed / (2.0f * accel);
+    bool braking = (remaining > 0) != (speed > 0.0f) || stopping >= fabsf((float)remaining);
+    float ramp = accel * dt;
+    if (speed == 0.0f || !braking) {
+      float direction = remaining > 0 ? 1.0f : -1.0f;
+      speed = constrain(speed + direction * ramp, -maxSpeed, maxSpeed);
+    } else {
+      speed = speed > 0.0f ? max(speed - ramp, 0.0f) : min(speed + ramp, 0.0f);
+    }
+
+    travel += speed * dt;
+    if (travel >= 1.0f || travel <= -1.0f) {
+      int step = travel > 0.0f ? 1 : -1;
+      travel -= step;
+      position += step;
+      digitalWrite(dirPin, step > 0 ? HIGH : LOW);
+      digitalWrite(stepPin, HIGH);
+      digitalWrite(stepPin, LOW);
+    }
+    if (position == target && fabsf(speed) < ramp) speed = 0.0f;
+    return true;
+  }
+
+ private:
+  const uint8_t stepPin, dirPin;
+  long position = 0;
+  long target = 0;
+  float maxSpeed = 1.0f;
+  float accel = 1.0f;
+  float speed = 0.0f;   // steps/s, signed
+  float travel = 0.0f;  // fraction of a step covered since the last one
+  unsigned long lastUs = 0;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <string>
+#include "sim.h"
+
+// ================================
+// ARDUINO CORE (SIMULATOR)
+// ================================
+// The slice of the Arduino-ESP32 core arm_controller.cpp uses, on the
+// simulator's virtual clock. Time only moves when sim_main.cpp advances it
+// (or the firmware calls delay()), so a run is deterministic and as fast
+// as the host can execute passes.
+#define HIGH 1
+#define LOW  0
+#define INPUT             0x01
+#define OUTPUT            0x03
+#define INPUT_PULLUP      0x05
+#define OUTPUT_OPEN_DRAIN 0x12
+
+#define IRAM_ATTR
+
+using std::abs;
+using std::max;
+using std::min;
+
+template <class T>
+T constrain(T x, T low, T high) { return x < low ? low : (x > high ? high : x); }
+
+inline unsigned long micros() { return (unsigned long)sim::nowUs; }
+inline unsigned long millis() { return (unsigned long)(sim::nowUs / 1000); }
+inline void delay(unsigned long ms) { sim::nowUs += ms * 1000ULL; }
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t level) { sim::pinWritten(pin, level); }
+int digitalRead(uint8_t pin);
+
+// Hardware timer, ESP32 Arduino 2.x API. sim_main.cpp calls the attached
+// handler once per alarm period of virtual time.
+struct hw_timer_t;
+hw_timer_t *timerBegin(uint8_t timer, uint16_t divider, bool countUp);
+void timerAttachInterrupt(hw_timer_t *timer, void (*handler)(), bool edge);
+void timerAlarmWrite(hw_timer_t *timer, uint64_t ticks, bool autoReload);
+void timerAlarmEnable(hw_timer_t *timer);
+
+// Serial: sim_main.cpp feeds `input` at `baud` and reads whole lines back
+// out of `output`.
+class HardwareSerial {
+ public:
+  std::deque<uint8_t> input;
+  std::string output;
+  unsigned long baud = 0;
+
+  void begin(unsigned long rate) { baud = rate; }
+  void updateBaudRate(unsigned long rate) { baud = rate; }
+  void flush() {}
+  int available() { return (int)input.size(); }
+  int read() {
+    if (input.empty()) return -1;
+    int c = input.front();
+    input.pop_front();
+    return c;
+  }
+
+  void print(const char *s) { output += s; }
+  void print(char c) { output += c; }
+  void print(int v) { output += std::to_string(v); }
+  void print(unsigned v) { output += std::to_string(v); }
+  void print(long v) { output += std::to_string(v); }
+  void print(unsigned long v) { output += std::to_string(v); }
+  void print(double v, int digits = 2) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, v);
+    output += buffer;
+  }
+  template <class T>
+  void println(T v) { print(v); output += '\n'; }
+  void println() { output += '\n'; }
+  void printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
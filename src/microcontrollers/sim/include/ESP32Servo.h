@@ -0,0 +1,29 @@
+#pragma once
+#include <Arduino.h>
+
+// ================================
+// ESP32Servo (SIMULATOR)
+// ================================
+// Reports every pulse width to the simulator; used when the firmware is
+// built with -DSERVO_LEDC=0.
+class Servo {
+ public:
+  int attach(int pin, int minUs = 544, int maxUs = 2400) {
+    this->pin = pin;
+    this->minUs = minUs;
+    this->maxUs = maxUs;
+    return 1;
+  }
+  void write(int degrees) {
+    degrees = constrain(degrees, 0, 180);
+    writeMicroseconds(minUs + (maxUs - minUs) * degrees / 180);
+  }
+  void writeMicroseconds(int pulseUs) {
+    if (pin >= 0) sim::servoPulse((uint8_t)pin, (float)pulseUs);
+  }
+
+ private:
+  int pin = -1;
+  int minUs = 544;
+  int maxUs = 2400;
+};
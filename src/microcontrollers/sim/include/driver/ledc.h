@@ -0,0 +1,84 @@
+#pragma once
+#include <Arduino.h>
+
+// ================================
+// LEDC DRIVER (SIMULATOR)
+// ================================
+// The ESP-IDF LEDC calls the SERVO OUTPUT section makes. A duty update is
+// reported to the simulator as the pulse width it produces, the way the
+// peripheral would latch it.
+typedef int esp_err_t;
+typedef enum { LEDC_LOW_SPEED_MODE = 0, LEDC_SPEED_MODE_MAX } ledc_mode_t;
+typedef enum { LEDC_TIMER_0, LEDC_TIMER_1, LEDC_TIMER_2, LEDC_TIMER_3, LEDC_TIMER_MAX } ledc_timer_t;
+typedef enum { LEDC_CHANNEL_0, LEDC_CHANNEL_MAX = 8 } ledc_channel_t;
+typedef enum { LEDC_TIMER_1_BIT = 1, LEDC_TIMER_20_BIT = 20 } ledc_timer_bit_t;
+typedef enum { LEDC_AUTO_CLK = 0 } ledc_clk_cfg_t;
+typedef enum { LEDC_INTR_DISABLE = 0 } ledc_intr_type_t;
+
+typedef struct {
+  ledc_mode_t speed_mode;
+  ledc_timer_bit_t duty_resolution;
+  ledc_timer_t timer_num;
+  uint32_t freq_hz;
+  ledc_clk_cfg_t clk_cfg;
+} ledc_timer_config_t;
+
+typedef struct {
+  int gpio_num;
+  ledc_mode_t speed_mode;
+  ledc_channel_t channel;
+  ledc_intr_type_t intr_type;
+  ledc_timer_t timer_sel;
+  uint32_t duty;
+  int hpoint;
+} ledc_channel_config_t;
+
+namespace sim {
+
+struct LedcState {
+  uint32_t freqHz[LEDC_TIMER_MAX];
+  uint8_t bits[LEDC_TIMER_MAX];
+  int gpio[LEDC_CHANNEL_MAX];
+  ledc_timer_t timer[LEDC_CHANNEL_MAX];
+  uint32_t duty[LEDC_CHANNEL_MAX];
+};
+
+inline LedcState &ledc() {
+  static LedcState state = {};
+  return state;
+}
+
+inline void ledcLatch(int channel) {
+  LedcState &s = ledc();
+  ledc_timer_t t = s.timer[channel];
+  if (s.freqHz[t] == 0 || s.gpio[channel] < 0) return;
+  float periodUs = 1000000.0f / s.freqHz[t];
+  sim::servoPulse((uint8_t)s.gpio[channel], s.duty[channel] * periodUs / (float)(1UL << s.bits[t]));
+}
+
+}  // namespace sim
+
+inline esp_err_t ledc_timer_config(const ledc_timer_config_t *config) {
+  sim::ledc().freqHz[config->timer_num] = config->freq_hz;
+  sim::ledc().bits[config->timer_num] = (uint8_t)config->duty_resolution;
+  return 0;
+}
+
+inline esp_err_t ledc_channel_config(const ledc_channel_config_t *config) {
+  sim::LedcState &s = sim::ledc();
+  s.gpio[config->channel] = config->gpio_num;
+  s.timer[config->channel] = config->timer_sel;
+  s.duty[config->channel] = config->duty;
+  sim::ledcLatch(config->channel);
+  return 0;
+}
+
+inline esp_err_t ledc_set_duty(ledc_mode_t, ledc_channel_t channel, uint32_t duty) {
+  sim::ledc().duty[channel] = duty;
+  return 0;
+}
+
+inline esp_err_t ledc_update_duty(ledc_mode_t, ledc_channel_t channel) {
+  sim::ledcLatch(channel);
+  return 0;
+}
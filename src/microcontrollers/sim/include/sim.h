@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+
+// ================================
+// SIMULATOR HOOKS
+// ================================
+// Shared by the stub headers in this directory and sim_main.cpp: the virtual
+// clock every stub reads, and the callbacks through which stubbed hardware
+// reports what the firmware drove.
+namespace sim {
+
+extern uint64_t nowUs;  // virtual time; only sim_main.cpp advances it
+
+void pinWritten(uint8_t pin, uint8_t level);  // digitalWrite
+void servoPulse(uint8_t pin, float pulseUs);  // servo output changed (either backend)
+
+}  // namespace sim
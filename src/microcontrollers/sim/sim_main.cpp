@@ -0,0 +1,499 @@
+// ================================
+// FIRMWARE SIMULATOR
+// ================================
+// Runs arm_controller.cpp unmodified on the host (pio run -e native). The
+// headers in sim/include stand in for the Arduino core and the servo, LEDC,
+// timer and stepper drivers, all on one virtual clock that only this file
+// advances, so signs play back deterministically and much faster than real
+// time.
+//
+// The host side mimics motion_io: every sign in the seed file that has keys
+// for this arm is sent as a JSON line at the firmware's baud rate, with a
+// sequence number, keeping a few commands in flight and pacing on DONE /
+// REJECTED. Servo pulses and shoulder STEP/DIR pins are decoded back into
+// joint angles for the optional CSV trace.
+//
+//   .pio/build/native/program [--signs PATH] [--limit N] [--step]
+//       [--window N] [--tick US] [--baud RATE] [--trace out.csv] [--serial]
+//       [--cut-stream] [--check-durations]
+//
+// --cut-stream first sends a STREAM_BEGIN whose chunks never come and a
+// binary MOTION frame right behind it: the cut stream must be REJECTED and
+// everything after it must still run. --check-durations fails a sign that
+// finishes sooner than its declared duration (sim/static_signs.json holds
+// one-keyframe signs, which must hold their pose even with others queued).
+
+#include <Arduino.h>
+#include <stdarg.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "arm_traits.h"
+
+void setup();
+void loop();
+uint16_t crc16Ccitt(const uint8_t *data, size_t length);
+
+#define SIM_TICK_US       10      // virtual time per loop() pass
+#define SIM_WINDOW        3       // commands in flight, like motion_io's default
+#define SIM_TIMEOUT_US    5000000UL  // per sign, on top of its own duration
+#define SIM_TRACE_US      10000UL    // CSV sample period
+#define SIM_COST_BUCKET_NS 10     // loop() cost histogram resolution
+#define SIM_COST_BUCKETS  10000   // up to 100 µs; slower passes land in the last
+
+// Binary frames for --cut-stream (BINARY FRAME PROTOCOL in arm_controller.cpp)
+#define SIM_FRAME_MAGIC        0xA5
+#define SIM_FRAME_MOTION       0x01
+#define SIM_FRAME_STREAM_BEGIN 0x04
+#define SIM_FRAME_FLAG_TIMED   0x01
+#define SIM_CHANNEL_ELBOW      0x04
+#define SIM_CUT_STREAM_KEYS    20  // keyframes the cut stream announces
+
+const int SIM_SERVOS = sizeof(Arm::servoPins) / sizeof(Arm::servoPins[0]);
+
+// ================================
+// VIRTUAL HARDWARE
+// ================================
+namespace sim {
+
+uint64_t nowUs = 0;
+
+uint8_t pinLevel[64];
+float servoDegrees[SIM_SERVOS];
+long rotationSteps = 0;
+long elevationSteps = 0;
+
+void pinWritten(uint8_t pin, uint8_t level) {
+  uint8_t previous = pinLevel[pin];
+  pinLevel[pin] = level;
+  if (level != HIGH || previous == HIGH) return;  // count rising STEP edges
+  if (pin == Arm::rotationStepPin) {
+    rotationSteps += pinLevel[Arm::rotationDirPin] == HIGH ? 1 : -1;
+  } else if (pin == Arm::elevationStepPin) {
+    elevationSteps += pinLevel[Arm::elevationDirPin] == HIGH ? 1 : -1;
+  }
+}
+
+void servoPulse(uint8_t pin, float pulseUs) {
+  for (int i = 0; i < SIM_SERVOS; i++) {
+    if (Arm::servoPins[i] != pin) continue;
+    float span = Arm::servoMaxUs[i] - Arm::servoMinUs[i];
+    servoDegrees[i] = (pulseUs - Arm::servoMinUs[i]) * 180.0f / span;
+  }
+}
+
+}  // namespace sim
+
+HardwareSerial Serial;
+
+// Any length, like the ESP32 core's Print::printf (the STATS line runs long)
+void HardwareSerial::printf(const char *format, ...) {
+  char buffer[256];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length < (int)sizeof(buffer)) {
+    output += buffer;
+    return;
+  }
+  std::vector<char> longer(length + 1);
+  va_start(args, format);
+  vsnprintf(longer.data(), longer.size(), format, args);
+  va_end(args);
+  output += longer.data();
+}
+
+int digitalRead(uint8_t pin) { return sim::pinLevel[pin]; }
+
+// One timer is all the firmware uses (SHOULDER_STEP_TIMER)
+struct hw_timer_t {
+  void (*handler)();
+  uint64_t periodUs;
+  uint64_t nextUs;
+  bool enabled;
+};
+
+static hw_timer_t simTimer;
+
+hw_timer_t *timerBegin(uint8_t, uint16_t, bool) { return &simTimer; }
+void timerAttachInterrupt(hw_timer_t *timer, void (*handler)(), bool) { timer->handler = handler; }
+void timerAlarmWrite(hw_timer_t *timer, uint64_t ticks, bool) { timer->periodUs = ticks; }
+void timerAlarmEnable(hw_timer_t *timer) {
+  timer->nextUs = sim::nowUs + timer->periodUs;
+  timer->enabled = timer->handler && timer->periodUs > 0;
+}
+
+// Fire every alarm that falls due up to the current virtual time
+static void runTimers() {
+  hw_timer_t &t = simTimer;
+  if (!t.enabled) return;
+  while (t.nextUs <= sim::nowUs) {
+    t.handler();
+    t.nextUs += t.periodUs;
+  }
+}
+
+// ================================
+// SIGN SOURCE
+// ================================
+// Splits the seed file's top-level array into one compact JSON line per sign.
+// A bracket scanner rather than a JSON library: it only has to drop
+// whitespace outside strings and find where each object ends.
+static std::vector<std::string> splitSigns(const std::string &text) {
+  std::vector<std::string> signs;
+  std::string current;
+  int depth = 0;
+  bool inString = false;
+  bool escaped = false;
+  for (char c : text) {
+    if (inString) {
+      current += c;
+      if (escaped) escaped = false;
+      else if (c == '\\') escaped = true;
+      else if (c == '"') inString = false;
+      continue;
+    }
+    if (isspace((unsigned char)c)) continue;
+    if (depth == 0 && c != '{') continue;  // the array's own brackets and commas
+    current += c;
+    if (c == '"') inString = true;
+    else if (c == '{' || c == '[') depth++;
+    else if (c == '}' || c == ']') {
+      if (--depth == 0) {
+        signs.push_back(current);
+        current.clear();
+      }
+    }
+  }
+  return signs;
+}
+
+static std::string jsonString(const std::string &json, const char *key) {
+  std::string needle = std::string("\"") + key + "\":\"";
+  size_t at = json.find(needle);
+  if (at == std::string::npos) return "";
+  at += needle.size();
+  return json.substr(at, json.find('"', at) - at);
+}
+
+static float jsonNumber(const std::string &json, const char *key, float fallback) {
+  std::string needle = std::string("\"") + key + "\":";
+  size_t at = json.find(needle);
+  return at == std::string::npos ? fallback : (float)atof(json.c_str() + at + needle.size());
+}
+
+static bool hasKey(const std::string &json, const char *key) {
+  return json.find(std::string("\"") + key + "\":") != std::string::npos;
+}
+
+// This arm's keys, or the side-neutral H/W/E/S every arm accepts
+static bool forThisArm(const std::string &json) {
+  return hasKey(json, Arm::handKey) || hasKey(json, Arm::wristKey) ||
+         hasKey(json, Arm::elbowKey) || hasKey(json, Arm::shoulderKey) ||
+         hasKey(json, "H") || hasKey(json, "W") || hasKey(json, "E") || hasKey(json, "S");
+}
+
+// ================================
+// HOST MODEL
+// ================================
+struct SimOptions {
+  std::string signsPath = "../signs/signs_to_seed.json";
+  std::string tracePath;
+  unsigned long tickUs = SIM_TICK_US;
+  int window = SIM_WINDOW;
+  unsigned long baud = 0;  // rate to negotiate with "!BAUD" first; 0 = boot rate
+  int limit = 0;          // 0 = every sign
+  bool stepTiming = false;  // leave "timing" unset (firmware DEFAULT_TIMING)
+  bool echoSerial = false;
+  bool cutStream = false;  // lead with a stream cut off before its first chunk
+  bool checkDurations = false;  // a sign that runs shorter than its duration fails
+};
+
+enum SignKind { SIGN_JSON, SIGN_STREAM_BEGIN, SIGN_MOTION_FRAME };
+
+struct SignRun {
+  std::string token;
+  std::string line;
+  float durationS;
+  SignKind kind = SIGN_JSON;
+  bool expectRejected = false;
+  uint8_t seq = 0;
+  uint64_t sentUs = 0;
+  uint64_t startedUs = 0;
+  uint64_t doneUs = 0;
+  bool rejected = false;
+  bool timedOut = false;
+  bool cutShort = false;
+};
+
+struct CostHistogram {
+  uint64_t count = 0;
+  uint64_t totalNs = 0;
+  uint64_t maxNs = 0;
+  uint32_t buckets[SIM_COST_BUCKETS] = {};
+
+  void record(uint64_t ns) {
+    count++;
+    totalNs += ns;
+    maxNs = max(maxNs, ns);
+    buckets[min(ns / SIM_COST_BUCKET_NS, (uint64_t)SIM_COST_BUCKETS - 1)]++;
+  }
+
+  uint64_t percentileNs(double p) const {
+    uint64_t want = (uint64_t)(count * p);
+    uint64_t seen = 0;
+    for (int i = 0; i < SIM_COST_BUCKETS; i++) {
+      seen += buckets[i];
+      if (seen > want) return (uint64_t)(i + 1) * SIM_COST_BUCKET_NS;
+    }
+    return maxNs;
+  }
+};
+
+static bool parseOptions(int argc, char **argv, SimOptions &options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (arg == "--signs" && hasValue) options.signsPath = argv[++i];
+    else if (arg == "--trace" && hasValue) options.tracePath = argv[++i];
+    else if (arg == "--tick" && hasValue) options.tickUs = max(strtoul(argv[++i], nullptr, 10), 1UL);
+    else if (arg == "--window" && hasValue) options.window = max(atoi(argv[++i]), 1);
+    else if (arg == "--baud" && hasValue) options.baud = strtoul(argv[++i], nullptr, 10);
+    else if (arg == "--limit" && hasValue) options.limit = atoi(argv[++i]);
+    else if (arg == "--step") options.stepTiming = true;
+    else if (arg == "--serial") options.echoSerial = true;
+    else if (arg == "--cut-stream") options.cutStream = true;
+    else if (arg == "--check-durations") options.checkDurations = true;
+    else {
+      fprintf(stderr,
+              "usage: %s [--signs PATH] [--limit N] [--step] [--window N] "
+              "[--tick US] [--baud RATE] [--trace out.csv] [--serial] [--cut-stream] "
+              "[--check-durations]\n", argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
+
+// The seq goes in front of the line and "timing":"timed" (unless the sign or
+// --step says otherwise) right after the opening brace, the way motion_io
+// sends them
+static std::string withSeq(const std::string &json, uint8_t seq, bool stepTiming) {
+  if (stepTiming || hasKey(json, "timing")) return std::to_string(seq) + " " + json + "\n";
+  return std::to_string(seq) + " {\"timing\":\"timed\"," + json.substr(1) + "\n";
+}
+
+// magic, length, payload, CRC
+static std::string binaryFrame(const std::string &payload) {
+  uint16_t crc = crc16Ccitt((const uint8_t *)payload.data(), payload.size());
+  std::string frame(1, (char)SIM_FRAME_MAGIC);
+  frame += (char)(payload.size() & 0xFF);
+  frame += (char)(payload.size() >> 8);
+  return frame + payload + (char)(crc & 0xFF) + (char)(crc >> 8);
+}
+
+// STREAM_BEGIN with no chunks to follow, or a one-keyframe MOTION (elbow at 90)
+static std::string withSeqFrame(const SignRun &run, uint8_t seq) {
+  uint16_t durationMs = (uint16_t)lroundf(run.durationS * 1000.0f);
+  std::string payload;
+  payload += (char)(run.kind == SIGN_STREAM_BEGIN ? SIM_FRAME_STREAM_BEGIN : SIM_FRAME_MOTION);
+  payload += (char)seq;
+  payload += (char)SIM_FRAME_FLAG_TIMED;
+  payload += (char)(durationMs & 0xFF);
+  payload += (char)(durationMs >> 8);
+  payload += (char)run.token.size();
+  payload += run.token;
+  if (run.kind == SIGN_STREAM_BEGIN) {
+    payload += (char)SIM_CUT_STREAM_KEYS;
+    payload += (char)0;
+  } else {
+    const char keyframe[] = {1, 0, 0, SIM_CHANNEL_ELBOW, 90};  // count, time 0 ms, mask, elbow
+    payload.append(keyframe, sizeof(keyframe));
+  }
+  return binaryFrame(payload);
+}
+
+static SignRun *findRun(std::vector<SignRun> &runs, size_t sent, int seq) {
+  for (size_t i = sent; i-- > 0;) {
+    if (runs[i].seq == seq && runs[i].doneUs == 0 && !runs[i].rejected && !runs[i].timedOut) {
+      return &runs[i];
+    }
+  }
+  return nullptr;
+}
+
+int main(int argc, char **argv) {
+  SimOptions options;
+  if (!parseOptions(argc, argv, options)) return 2;
+
+  std::ifstream file(options.signsPath);
+  if (!file) {
+    fprintf(stderr, "cannot read %s\n", options.signsPath.c_str());
+    return 1;
+  }
+  std::stringstream text;
+  text << file.rdbuf();
+
+  std::vector<SignRun> runs;
+  if (options.cutStream) {
+    SignRun cut;
+    cut.token = "CUT_STREAM";
+    cut.durationS = 2.0f;
+    cut.kind = SIGN_STREAM_BEGIN;
+    cut.expectRejected = true;
+    runs.push_back(cut);
+    SignRun next;
+    next.token = "AFTER_CUT";
+    next.durationS = 0.5f;
+    next.kind = SIGN_MOTION_FRAME;
+    runs.push_back(next);
+  }
+  for (const std::string &json : splitSigns(text.str())) {
+    if (!forThisArm(json)) continue;
+    SignRun run;
+    run.token = jsonString(json, "token");
+    run.line = json;
+    run.durationS = jsonNumber(json, "duration", 1.0f);
+    runs.push_back(run);
+    if (options.limit > 0 && (int)runs.size() >= options.limit) break;
+  }
+
+  FILE *trace = nullptr;
+  if (!options.tracePath.empty()) {
+    trace = fopen(options.tracePath.c_str(), "w");
+    if (!trace) {
+      fprintf(stderr, "cannot write %s\n", options.tracePath.c_str());
+      return 1;
+    }
+    fprintf(trace, "time_s,token");
+    for (int i = 0; i < SIM_SERVOS; i++) fprintf(trace, ",servo%d", i);
+    fprintf(trace, ",rotation_deg,elevation_deg\n");
+  }
+
+  printf(ARM_TAG "simulating %zu signs from %s\n", runs.size(), options.signsPath.c_str());
+  std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+  setup();
+
+  double nextByteUs = (double)sim::nowUs;
+  std::string pending;  // bytes of the command being sent
+  // Link speed handshake (LINK SPEED in the firmware): "!BAUD", then a PING
+  // at the new rate, before any sign goes out
+  bool linkReady = options.baud == 0;
+  if (!linkReady) pending = "!BAUD " + std::to_string(options.baud) + "\n";
+  std::string received;
+  size_t sent = 0;
+  size_t finished = 0;
+  int inFlight = 0;
+  uint8_t nextSeq = 1;
+  std::string running;  // token of the plan executing now, for the trace
+  uint64_t nextTraceUs = sim::nowUs;
+  CostHistogram cost;
+
+  while (finished < runs.size()) {
+    // Host: queue the next sign once the previous one is fully on the wire
+    if (linkReady && pending.empty() && sent < runs.size() && inFlight < options.window) {
+      SignRun &run = runs[sent++];
+      run.seq = nextSeq;
+      nextSeq = nextSeq == 255 ? 1 : nextSeq + 1;
+      run.sentUs = sim::nowUs;
+      pending = run.kind == SIGN_JSON ? withSeq(run.line, run.seq, options.stepTiming)
+                                      : withSeqFrame(run, run.seq);
+      inFlight++;
+    }
+    while (!pending.empty() && nextByteUs <= (double)sim::nowUs) {
+      Serial.input.push_back((uint8_t)pending[0]);
+      pending.erase(0, 1);
+      nextByteUs += 10.0 * 1000000.0 / Serial.baud;  // 8N1
+    }
+    if (pending.empty() && nextByteUs < (double)sim::nowUs) nextByteUs = (double)sim::nowUs;
+
+    std::chrono::steady_clock::time_point passStart = std::chrono::steady_clock::now();
+    loop();
+    cost.record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - passStart).count());
+
+    sim::nowUs += options.tickUs;
+    runTimers();
+
+    // Host: read back whole lines
+    received += Serial.output;
+    Serial.output.clear();
+    size_t newline;
+    while ((newline = received.find('\n')) != std::string::npos) {
+      std::string line = received.substr(0, newline);
+      received.erase(0, newline + 1);
+      if (options.echoSerial) printf("  | %s\n", line.c_str());
+
+      int seq = 0;
+      unsigned long rate = 0;
+      SignRun *run = nullptr;
+      if (!linkReady && sscanf(line.c_str(), "BAUD %lu", &rate) == 1) {
+        if (rate == options.baud) pending = "!PING 0\n";
+        else linkReady = true;  // refused; stay at the boot rate
+      } else if (!linkReady && line.compare(0, 7, "PONG 0 ") == 0) {
+        linkReady = true;
+      } else if (sscanf(line.c_str(), "STARTED %d", &seq) == 1 && (run = findRun(runs, sent, seq))) {
+        run->startedUs = sim::nowUs;
+        running = run->token;
+      } else if (sscanf(line.c_str(), "DONE %d", &seq) == 1 && (run = findRun(runs, sent, seq))) {
+        run->doneUs = sim::nowUs;
+        uint64_t began = run->startedUs ? run->startedUs : run->sentUs;
+        uint64_t ranUs = run->doneUs - began;
+        run->cutShort = options.checkDurations && ranUs + options.tickUs < (uint64_t)(run->durationS * 1e6f);
+        printf("  %-20s seq %3u  started %8.3f s  ran %6.3f s (script %.3f s)%s\n",
+               run->token.c_str(), run->seq, began / 1e6, ranUs / 1e6, run->durationS,
+               run->cutShort ? "  SHORT" : "");
+        finished++;
+        inFlight--;
+      } else if (sscanf(line.c_str(), "REJECTED %d", &seq) == 1 && (run = findRun(runs, sent, seq))) {
+        run->rejected = true;
+        printf("  %-20s seq %3u  REJECTED\n", run->token.c_str(), run->seq);
+        finished++;
+        inFlight--;
+      }
+    }
+
+    for (size_t i = 0; i < sent; i++) {
+      SignRun &run = runs[i];
+      if (run.doneUs || run.rejected || run.timedOut) continue;
+      if (sim::nowUs - run.sentUs > SIM_TIMEOUT_US + (uint64_t)(run.durationS * 1e6f) * options.window) {
+        run.timedOut = true;
+        printf("  %-20s seq %3u  TIMEOUT\n", run.token.c_str(), run.seq);
+        finished++;
+        inFlight--;
+      }
+    }
+
+    if (trace && sim::nowUs >= nextTraceUs) {
+      fprintf(trace, "%.3f,%s", sim::nowUs / 1e6, running.c_str());
+      for (int i = 0; i < SIM_SERVOS; i++) fprintf(trace, ",%.1f", sim::servoDegrees[i]);
+      fprintf(trace, ",%.2f,%.2f\n",
+              Arm::shoulderDirection * sim::rotationSteps / Arm::rotationStepsPerDeg,
+              Arm::shoulderDirection * sim::elevationSteps / Arm::elevationStepsPerDeg);
+      nextTraceUs += SIM_TRACE_US;
+    }
+  }
+
+  double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  double virtualS = sim::nowUs / 1e6;
+  int done = 0, rejected = 0, timedOut = 0, cutShort = 0, unexpected = 0;
+  for (const SignRun &run : runs) {
+    done += run.doneUs != 0;
+    rejected += run.rejected;
+    timedOut += run.timedOut;
+    cutShort += run.cutShort;
+    unexpected += run.timedOut || run.cutShort || run.rejected != run.expectRejected;
+  }
+  printf(ARM_TAG "%d done, %d rejected, %d timed out at %lu baud\n", done, rejected, timedOut, Serial.baud);
+  if (options.checkDurations) printf(ARM_TAG "%d ran shorter than their duration\n", cutShort);
+  printf(ARM_TAG "virtual %.3f s in %.3f s wall (%.0fx real time)\n",
+         virtualS, wallS, wallS > 0 ? virtualS / wallS : 0.0);
+  printf(ARM_TAG "loop() mean %.0f ns, p50 %llu ns, p99 %llu ns, max %llu ns over %llu passes\n",
+         cost.count ? (double)cost.totalNs / cost.count : 0.0,
+         (unsigned long long)cost.percentileNs(0.50), (unsigned long long)cost.percentileNs(0.99),
+         (unsigned long long)cost.maxNs, (unsigned long long)cost.count);
+  if (trace) fclose(trace);
+  return unexpected ? 1 : 0;
+}
@@ -0,0 +1,2259 @@
+#include <Arduino.h>
+#include <ESP32Servo.h>
+#include <ArduinoJson.h>
+#include <AccelStepper.h>
+#include <atomic>
+#include <driver/ledc.h>
+#include "arm_traits.h"
+
+// ================================
+// CONFIGURATION
+// ================================
+// Servos per arm: Hand (5) + Wrist (2) + Elbow (1) = 8 total
+// Shoulder joints are stepper motors (A4988). Pins, JSON keys and stepper
+// calibration are per-arm traits (include/arm_traits.h).
+#define HAND_SERVO_COUNT  5
+#define WRIST_SERVO_COUNT 2
+#define ELBOW_SERVO_COUNT 1
+#define TOTAL_SERVO_COUNT 8
+
+#define MAX_QUEUE          8      // command slots buffered ahead of the running motion
+#define CMD_SLOT_SIZE      2048   // bytes per command line: the old 2 KB JSON document limit; the largest
+                                  // seeded script (CELEBRATE) is ~770 B unprojected, the largest in
+                                  // signs_to_seed_refresh.json (EXCHANGE) ~1.45 KB
+#define BAUD_RATE          115200  // boot rate; the host may raise it (see LINK SPEED)
+#define BAUD_MAX           2000000
+#define BAUD_CONFIRM_MS    1000      // revert to BAUD_RATE unless a PING arrives at the new rate
+#define DEFAULT_STEP_DELAY 2   // ms per servo update (control tick)
+#define DEFAULT_STEP_DELAY_US (DEFAULT_STEP_DELAY * 1000UL)
+
+#define JSON_ARENA_SIZE 12288  // parse arena for one JSON command (see JSON PARSE ARENA)
+
+#define MAX_KEYFRAMES 16   // keyframes held per parsed motion plan
+#define MAX_TOKEN_LEN 32
+#define PLAN_QUEUE_SIZE 4  // plan ring: the executing one + up to 2 ready + the slot being parsed into
+
+// Run receive/parse and motion as two FreeRTOS tasks on separate cores (see
+// TASKS below). 0 = everything in loop(), as on a single-core build.
+#ifndef DUAL_CORE_TASKS
+#define DUAL_CORE_TASKS 1
+#endif
+#define INGEST_TASK_CORE     0
+#define INGEST_TASK_PRIORITY 1
+#define INGEST_TASK_STACK    4096   // JSON document lives in jsonArena, not here
+#define MOTION_TASK_CORE     1
+#define MOTION_TASK_PRIORITY 3      // above loopTask/idle on core 1
+#define MOTION_TASK_STACK    4096
+
+// Playback timing when a command has no "timing" field:
+//   "step"  — servos move on their speed/acceleration profiles (see SERVO
+//             PROFILES), then dwell duration / frameCount
+//   "timed" — each joint is interpolated from keyframe N to N+1 across
+//             exactly time[N+1] - time[N] seconds
+#define DEFAULT_TIMING "step"
+
+// Sign-to-sign blending (see BLENDING below): when the next timed sign is
+// already queued, curve from the end of the current sign's final hold straight
+// into the next sign's first keyframe without stopping. 0 = every sign ends at rest.
+#ifndef BLEND_SIGNS
+#define BLEND_SIGNS 1
+#endif
+#define BLEND_MIN_MS 80  // shortest transition between blended signs
+
+// Binary motion frames (see BINARY FRAME PROTOCOL below). A command whose
+// first byte is FRAME_MAGIC is a length-prefixed frame; anything else is a
+// '\n'-terminated JSON line.
+#define FRAME_MAGIC        0xA5
+#define FRAME_HEADER_SIZE  3      // magic + uint16 payload length
+#define FRAME_CRC_SIZE     2
+#define FRAME_TIMEOUT_US   50000  // abandon a frame whose bytes stop arriving
+#define FRAME_TYPE_MOTION  0x01
+#define FRAME_TYPE_STORE   0x02   // upload a motion into the sign cache
+#define FRAME_TYPE_PLAY    0x03   // play a cached motion by id
+#define FRAME_TYPE_STREAM_BEGIN 0x04  // header of a streamed sign (see STREAMING)
+#define FRAME_TYPE_STREAM_KEYS  0x05  // next chunk of its keyframes
+#define STREAM_CHUNK_MAX   (MAX_KEYFRAMES - 2)  // largest chunk that can always fit
+#define FRAME_FLAG_TIMED   0x01
+#define FRAME_FLAG_SYNC    0x02   // hold the plan for a synchronized start
+#define FRAME_FLAG_FINE    0x04   // servo fields are uint16 tenths of a degree
+#define FRAME_FLAG_SAMPLED 0x08   // keyframes are fixed-rate setpoints (see SAMPLED PLAYBACK)
+
+// Sign cache (see SIGN CACHE below): motions that never change, played by id
+#define SIGN_CACHE_SIZE 32   // ~26 KB of parsed plans
+#define SIGN_ID_REST    0    // baked into firmware; ids 1+ are uploaded by the host
+#ifndef IDLE_REST_MS
+#define IDLE_REST_MS    1500 // glide to rest after this long without a command; 0 = never (see IDLE REST)
+#endif
+
+// Synchronized two-arm start (see SYNCHRONIZED START below)
+#define CONTROL_PREFIX     '!'    // "!PING", "!GO" lines: handled on arrival, never queued
+#define CONTROL_LINE_SIZE  32
+#define SYNC_TIMEOUT_MS    1000   // a held plan starts anyway if no GO arrives
+#ifndef SYNC_TRIGGER_PIN
+#define SYNC_TRIGGER_PIN   -1     // open-drain line wired to the other arm; -1 = GO only
+#endif
+#define SYNC_TRIGGER_HOLD_MS 5    // keep the line released this long after starting
+
+#define SHOULDER_MAX_SPEED 6000.0f
+#define SHOULDER_ACCEL     5000.0f
+
+// Servo speed (°/s) and acceleration (°/s²) limits per joint class (see
+// SERVO PROFILES). The elbow carries the forearm and hand, so it ramps gentlest.
+#define HAND_MAX_SPEED  700.0f
+#define HAND_ACCEL      8000.0f
+#define WRIST_MAX_SPEED 500.0f
+#define WRIST_ACCEL     5000.0f
+#define ELBOW_MAX_SPEED 350.0f
+#define ELBOW_ACCEL     3000.0f
+
+// Servo output (see SERVO OUTPUT below). Positions are kept in tenths of a
+// degree and written as pulse widths, latched at most once per PWM period.
+// 1 = all servos on one LEDC timer, written as raw duty; 0 = ESP32Servo.
+#ifndef SERVO_LEDC
+#define SERVO_LEDC 1
+#endif
+#define SERVO_SCALE       10     // position units per degree
+#define SERVO_MAX_POS     (180 * SERVO_SCALE)
+#define SERVO_PWM_HZ      50
+#define SERVO_PERIOD_US   (1000000UL / SERVO_PWM_HZ)
+#define SERVO_DUTY_BITS   16     // 20 ms / 2^16 = 0.3 µs per count
+
+// Generate shoulder STEP pulses from a hardware timer ISR (see TimerStepper)
+// instead of polling AccelStepper::run(). 0 = AccelStepper fallback.
+#ifndef SHOULDER_STEP_TIMER
+#define SHOULDER_STEP_TIMER 1
+#endif
+#define STEP_TIMER_HZ 20000  // ISR rate; top step rate is half (pulse high, then low)
+
+// ================================
+// SERVO DECLARATIONS
+// ================================
+// All servos are addressed as channels in one table (see JOINT TABLE):
+// hand 0-4 (Thumb, Index, Middle, Ring, Pinky), wrist 5-6, elbow 7
+#define SERVO_HAND  0
+#define SERVO_WRIST HAND_SERVO_COUNT
+#define SERVO_ELBOW (HAND_SERVO_COUNT + WRIST_SERVO_COUNT)
+
+typedef uint8_t ServoMask;  // one bit per channel
+#define SERVO_GROUP_MASK(first, count) ((ServoMask)(((1u << (count)) - 1) << (first)))
+#define HAND_MASK  SERVO_GROUP_MASK(SERVO_HAND,  HAND_SERVO_COUNT)
+#define WRIST_MASK SERVO_GROUP_MASK(SERVO_WRIST, WRIST_SERVO_COUNT)
+#define ELBOW_MASK SERVO_GROUP_MASK(SERVO_ELBOW, ELBOW_SERVO_COUNT)
+
+static_assert(HAND_SERVO_COUNT + WRIST_SERVO_COUNT + ELBOW_SERVO_COUNT == TOTAL_SERVO_COUNT, "servo groups");
+static_assert(TOTAL_SERVO_COUNT <= 8 * sizeof(ServoMask), "ServoMask holds every channel");
+static_assert(sizeof(Arm::servoPins) == TOTAL_SERVO_COUNT, "one pin per servo");
+static_assert(sizeof(Arm::servoMinDeg) == TOTAL_SERVO_COUNT && sizeof(Arm::servoMaxDeg) == TOTAL_SERVO_COUNT,
+              "one travel limit per servo");
+
+// ================================
+// CHANNEL LIMITS
+// ================================
+// Travel per channel, loaded from the arm_traits.h tables at boot. Keyframe
+// targets are clamped to it as they are parsed (counted in STATS clamped=),
+// and every servo write is clamped again, so no lead-in, blend or sample can
+// drive a servo into its hard stop or a shoulder past its travel.
+struct ChannelLimits {
+  uint16_t servoMin[TOTAL_SERVO_COUNT];  // position units (see SERVO_SCALE)
+  uint16_t servoMax[TOTAL_SERVO_COUNT];
+  float rotationMinDeg, rotationMaxDeg;
+  float elevationMinDeg, elevationMaxDeg;
+};
+
+ChannelLimits limits;
+
+void loadChannelLimits() {
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    limits.servoMin[i] = Arm::servoMinDeg[i] * SERVO_SCALE;
+    limits.servoMax[i] = Arm::servoMaxDeg[i] * SERVO_SCALE;
+  }
+  limits.rotationMinDeg  = Arm::rotationMinDeg;
+  limits.rotationMaxDeg  = Arm::rotationMaxDeg;
+  limits.elevationMinDeg = Arm::elevationMinDeg;
+  limits.elevationMaxDeg = Arm::elevationMaxDeg;
+}
+
+int limitServo(int channel, int position) {
+  return constrain(position, (int)limits.servoMin[channel], (int)limits.servoMax[channel]);
+}
+
+// ================================
+// SERVO OUTPUT
+// ================================
+// Positions (tenths of a degree, see SERVO_SCALE) map linearly onto each
+// channel's calibrated pulse range. With SERVO_LEDC every channel shares one
+// LEDC timer and the mapping is folded into two precomputed duty constants,
+// so a write is a multiply, a shift and a register update. Duty changes take
+// effect at the start of the timer's next period, so channels written
+// together switch together.
+#if SERVO_LEDC
+#define SERVO_LEDC_MODE  LEDC_LOW_SPEED_MODE
+#define SERVO_LEDC_TIMER LEDC_TIMER_3  // clear of the timers analogWrite() hands out first
+
+uint32_t servoDutyZero[TOTAL_SERVO_COUNT];  // duty at 0°
+uint32_t servoDutyStep[TOTAL_SERVO_COUNT];  // duty per position unit, Q16
+
+uint32_t servoDuty(int channel, int position) {
+  return servoDutyZero[channel] + ((servoDutyStep[channel] * (uint32_t)position) >> 16);
+}
+
+void attachServos(const int *positions) {
+  ledc_timer_config_t timer = {};
+  timer.speed_mode = SERVO_LEDC_MODE;
+  timer.duty_resolution = (ledc_timer_bit_t)SERVO_DUTY_BITS;
+  timer.timer_num = SERVO_LEDC_TIMER;
+  timer.freq_hz = SERVO_PWM_HZ;
+  timer.clk_cfg = LEDC_AUTO_CLK;
+  ledc_timer_config(&timer);
+
+  const float countsPerUs = (float)(1UL << SERVO_DUTY_BITS) / SERVO_PERIOD_US;
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    float spanCounts = (Arm::servoMaxUs[i] - Arm::servoMinUs[i]) * countsPerUs;
+    servoDutyZero[i] = (uint32_t)lroundf(Arm::servoMinUs[i] * countsPerUs);
+    servoDutyStep[i] = (uint32_t)lroundf(spanCounts / SERVO_MAX_POS * 65536.0f);
+
+    ledc_channel_config_t channel = {};
+    channel.gpio_num = Arm::servoPins[i];
+    channel.speed_mode = SERVO_LEDC_MODE;
+    channel.channel = (ledc_channel_t)i;
+    channel.timer_sel = SERVO_LEDC_TIMER;
+    channel.duty = servoDuty(i, positions[i]);
+    channel.hpoint = 0;
+    ledc_channel_config(&channel);
+  }
+}
+
+void writeServo(int channel, int position) {
+  position = limitServo(channel, position);
+  ledc_set_duty(SERVO_LEDC_MODE, (ledc_channel_t)channel, servoDuty(channel, position));
+  ledc_update_duty(SERVO_LEDC_MODE, (ledc_channel_t)channel);
+}
+#else
+Servo servos[TOTAL_SERVO_COUNT];
+
+void writeServo(int channel, int position) {
+  position = limitServo(channel, position);
+  long span = Arm::servoMaxUs[channel] - Arm::servoMinUs[channel];
+  servos[channel].writeMicroseconds(Arm::servoMinUs[channel] + span * position / SERVO_MAX_POS);
+}
+
+void attachServos(const int *positions) {
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    servos[i].attach(Arm::servoPins[i], Arm::servoMinUs[i], Arm::servoMaxUs[i]);
+    writeServo(i, positions[i]);
+  }
+}
+#endif
+
+// ================================
+// SHOULDER STEPPER OBJECTS
+// ================================
+#if SHOULDER_STEP_TIMER
+// Trapezoidal STEP/DIR generator ticked from a hardware timer at
+// STEP_TIMER_HZ, so the shoulders reach full speed regardless of how busy the
+// motion task is. Exposes the subset of the AccelStepper API the motion engine
+// uses (run() is a no-op).
+//
+// The ESP32 cannot use the FPU inside an ISR, so the tick works in integers:
+// speed and acceleration are fractions of a step per tick scaled by 2^32, and
+// a step is taken whenever the 32-bit phase accumulator carries. Every field
+// the task side writes is a single aligned 32-bit word.
+class TimerStepper {
+ public:
+  TimerStepper(uint8_t stepPin, uint8_t dirPin) : stepPin(stepPin), dirPin(dirPin) {}
+
+  void setMaxSpeed(float stepsPerSec) {
+    float perTick = min(stepsPerSec / STEP_TIMER_HZ, 0.5f);  // carry at most every other tick
+    maxSpeed = (uint32_t)(perTick * 4294967296.0f);
+  }
+  void setAcceleration(float stepsPerSec2) {
+    float perTick2 = stepsPerSec2 / ((float)STEP_TIMER_HZ * STEP_TIMER_HZ);
+    accel = max((uint32_t)(perTick2 * 4294967296.0f), (uint32_t)1);
+  }
+  void moveTo(long position) { target = position; }
+  long distanceToGo() { return target - position; }
+  long currentPosition() { return position; }
+  bool run() { return distanceToGo() != 0; }
+  // Come to rest from the current speed, like AccelStepper::stop(). Reads the
+  // ISR's speed and direction; a tick landing in between moves it one step.
+  void stop() {
+    uint64_t stopping = (((uint64_t)speed * speed) >> 32) / (2 * (uint64_t)accel);
+    target = position + direction * (long)stopping;
+  }
+
+  void IRAM_ATTR tick() {
+    if (pulseHigh) {
+      digitalWrite(stepPin, LOW);
+      pulseHigh = false;
+    }
+
+    long remaining = target - position;
+    if (speed == 0) {
+      if (remaining == 0) return;
+      direction = remaining > 0 ? 1 : -1;
+      digitalWrite(dirPin, direction > 0 ? HIGH : LOW);
+      phase = 0;
+    }
+
+    long ahead = remaining * direction;  // < 0 when the target moved behind us
+    if (ahead == 0) {
+      speed = 0;
+      return;
+    }
+
+    // Brake once the stopping distance v^2 / 2a reaches what is left
+    // (32x32 -> 64-bit products only, which stay inline in the ISR)
+    uint32_t a = accel;
+    uint32_t top = maxSpeed;
+    uint64_t stopping = ((uint64_t)speed * speed) >> 32;
+    if (ahead < 0 || stopping >= (uint64_t)(2 * a) * (uint32_t)ahead) {
+      speed = speed > a ? speed - a : 0;
+      if (speed == 0) return;  // re-plan direction next tick
+    } else if (speed < top) {
+      speed = min(speed + a, top);
+    } else if (speed > top) {
+      speed = max(speed - a, top);
+    }
+
+    uint32_t previous = phase;
+    phase += speed;
+    if (phase < previous) {
+      position += direction;
+      digitalWrite(stepPin, HIGH);
+      pulseHigh = true;
+    }
+  }
+
+ private:
+  const uint8_t stepPin, dirPin;
+  volatile long target = 0;
+  volatile long position = 0;
+  volatile uint32_t maxSpeed = 0;
+  volatile uint32_t accel = 1;
+  // ISR-only state
+  uint32_t speed = 0;
+  uint32_t phase = 0;
+  int8_t direction = 1;
+  bool pulseHigh = false;
+};
+
+TimerStepper shoulderRotation(Arm::rotationStepPin, Arm::rotationDirPin);
+TimerStepper shoulderFlexion(Arm::elevationStepPin,  Arm::elevationDirPin);
+
+hw_timer_t *stepTimer = nullptr;
+
+void IRAM_ATTR onStepTimer() {
+  shoulderRotation.tick();
+  shoulderFlexion.tick();
+}
+
+void startStepTimer() {
+#if ESP_ARDUINO_VERSION_MAJOR >= 3
+  stepTimer = timerBegin(1000000);  // 1 MHz timebase
+  timerAttachInterrupt(stepTimer, &onStepTimer);
+  timerAlarm(stepTimer, 1000000 / STEP_TIMER_HZ, true, 0);
+#else
+  stepTimer = timerBegin(0, 80, true);  // 80 MHz APB / 80 = 1 MHz
+  timerAttachInterrupt(stepTimer, &onStepTimer, true);
+  timerAlarmWrite(stepTimer, 1000000 / STEP_TIMER_HZ, true);
+  timerAlarmEnable(stepTimer);
+#endif
+}
+#else
+// AccelStepper::DRIVER = STEP + DIR interface (MS1/MS2 hardwired on driver board)
+AccelStepper shoulderRotation(AccelStepper::DRIVER, Arm::rotationStepPin, Arm::rotationDirPin);
+AccelStepper shoulderFlexion(AccelStepper::DRIVER,  Arm::elevationStepPin, Arm::elevationDirPin);
+#endif
+
+// ================================
+// STATISTICS
+// ================================
+// Hot-path timing counters kept in RAM and dumped by "!STATS" as one line:
+//
+//   STATS up=<s> rx=<t> parse=<t> start=<t> late=<t> loop=<t>
+//         queue=<high-water>/<MAX_QUEUE> busy=<n> bad=<n> rejected=<n> clamped=<n>
+//
+// where each <t> is count,mean µs,max µs,histogram. The histogram has
+// STATS_BUCKETS counts split at 64 µs, 256 µs, 1 ms, ... (powers of 4),
+// ':'-separated.
+//
+//   rx     command fully received -> parsed into a plan (queueing + parse)
+//   parse  time spent in the parser alone (JSON or binary frame)
+//   start  plan published -> its first keyframe begins (includes waiting
+//          behind the running sign or for a synchronized start)
+//   late   timed playback: how far past its scheduled end each segment is
+//          noticed, i.e. how late keyframes land against "time"
+//   loop   motion engine pass-to-pass period while a plan runs
+//   busy / bad / rejected   commands dropped: slots full (BUSY), corrupt
+//          or oversize frames and lines, and commands that failed to parse
+//   clamped  keyframe values pulled inside their channel's travel (see
+//          CHANNEL LIMITS)
+//
+// Each counter has a single writer (ingest or motion); "!STATS" reads them
+// from the ingest side without locking, which is fine for diagnostics.
+// "!STATS CLEAR" dumps and then zeroes them.
+#define STATS_BUCKETS 8
+
+struct TimingStat {
+  uint32_t count;
+  uint32_t maxUs;
+  uint64_t totalUs;
+  uint32_t histogram[STATS_BUCKETS];
+
+  void record(uint32_t us) {
+    count++;
+    totalUs += us;
+    if (us > maxUs) maxUs = us;
+    int bits = 32 - __builtin_clz(us | 1);  // 64 µs has 7 bits
+    histogram[constrain((bits - 5) / 2, 0, STATS_BUCKETS - 1)]++;
+  }
+
+  // Appends " name=count,avg,max,h0:h1:..." at line + length; returns the new length
+  size_t format(char *line, size_t size, size_t length, const char *name) const {
+    length += snprintf(line + length, size - length, " %s=%lu,%lu,%lu,", name, (unsigned long)count,
+                       (unsigned long)(count ? totalUs / count : 0), (unsigned long)maxUs);
+    for (int b = 0; b < STATS_BUCKETS && length < size; b++) {
+      length += snprintf(line + length, size - length, b ? ":%lu" : "%lu", (unsigned long)histogram[b]);
+    }
+    return length < size ? length : size - 1;
+  }
+};
+
+struct Stats {
+  TimingStat rx, parse, start, late, loop;
+  int queueHighWater;
+  uint32_t busy, bad, rejected, clamped;
+  uint32_t cutStreams;  // rejected on the motion side (see reportRejected); reported in rejected=
+};
+
+Stats stats = {};
+
+// Built in full first: the report is one line and must go out in one write
+// (see TASKS), or a motion-side DONE could land in the middle of it.
+void printStats() {
+  static char line[768];  // worst case ~700 with every counter at 10 digits
+  size_t length = snprintf(line, sizeof(line), "STATS up=%lu", (unsigned long)(millis() / 1000));
+  length = stats.rx.format(line, sizeof(line), length, "rx");
+  length = stats.parse.format(line, sizeof(line), length, "parse");
+  length = stats.start.format(line, sizeof(line), length, "start");
+  length = stats.late.format(line, sizeof(line), length, "late");
+  length = stats.loop.format(line, sizeof(line), length, "loop");
+  Serial.printf("%s queue=%d/%d busy=%lu bad=%lu rejected=%lu clamped=%lu\n", line, stats.queueHighWater, MAX_QUEUE,
+                (unsigned long)stats.busy, (unsigned long)stats.bad, (unsigned long)(stats.rejected + stats.cutStreams),
+                (unsigned long)stats.clamped);
+}
+
+// ================================
+// COMMAND QUEUE
+// ================================
+// Fixed-capacity ring of pre-allocated line slots. Serial bytes are written
+// straight into the tail slot as they arrive and parsed in place from the
+// head slot, so each command is copied once and nothing touches the heap.
+struct CommandSlot {
+  size_t length;
+  unsigned long receivedUs;  // when its last byte arrived (see STATISTICS)
+  char data[CMD_SLOT_SIZE];
+};
+
+CommandSlot commandQueue[MAX_QUEUE];
+int queueHead = 0, queueTail = 0;
+// Occupied slots. Ingest is the only writer; motion reads it for the credits
+// in its STARTED/DONE/STOPPED replies (see FLOW CONTROL) from the other core.
+std::atomic<int> queueCount{0};
+
+// Receive state for the command being written into commandQueue[queueTail]
+size_t rxLength = 0;
+bool rxDiscarding = false;  // dropping the rest of a rejected command
+bool rxBinary = false;      // receiving a binary frame rather than a JSON line
+size_t rxFrameLength = 0;   // total bytes of the binary frame, once its header is in
+uint8_t rxHeader[FRAME_HEADER_SIZE];
+unsigned long lastRxUs = 0;
+bool rxControl = false;     // receiving a control line into controlLine
+char controlLine[CONTROL_LINE_SIZE];
+size_t controlLength = 0;
+
+// ================================
+// LINK SPEED
+// ================================
+// Every controller boots at BAUD_RATE. Once the boot banner is in, the host
+// proposes a faster rate with "!BAUD <rate>"; the firmware answers
+// "BAUD <rate>" at the old rate, switches, and waits for a "!PING" at the new
+// one. A switch the PING never confirms (the host or its USB bridge could not
+// follow) falls back to BAUD_RATE after BAUD_CONFIRM_MS. A rate outside
+// BAUD_RATE..BAUD_MAX is refused by answering with the current rate.
+unsigned long linkBaud = BAUD_RATE;
+bool baudUnconfirmed = false;
+uint32_t baudSwitchedMs = 0;
+
+void switchBaud(unsigned long rate) {
+  Serial.flush();  // the reply goes out at the old rate
+  Serial.updateBaudRate(rate);
+  linkBaud = rate;
+  baudSwitchedMs = millis();
+  baudUnconfirmed = rate != BAUD_RATE;
+}
+
+void proposeBaud(unsigned long rate) {
+  if (rate < BAUD_RATE || rate > BAUD_MAX) {
+    Serial.printf("BAUD %lu\n", linkBaud);
+    return;
+  }
+  Serial.printf("BAUD %lu\n", rate);
+  switchBaud(rate);
+}
+
+// ================================
+// PRIORITY COMMANDS
+// ================================
+// "!STOP", "!FLUSH" and "!REST" are control lines, so they are handled the
+// moment they arrive, ahead of any queued command:
+//
+//   !STOP    halt where the arm is and drop every queued command
+//   !FLUSH   drop every queued command; the current sign finishes
+//   !REST    as STOP, then glide to the rest pose (see IDLE REST)
+//
+// Ingest empties the command slots at once and hands the rest to the motion
+// side, which checks for it on every pass: it drops each plan published
+// before the request and answers "STOPPED <credits>", "FLUSHED <credits>" or
+// "RESTING <credits>". Dropped signs report nothing, and commands sent after
+// the request run normally. A streamed sign still arriving is ended at the
+// keyframes it has, so a FLUSH during one cuts it short.
+enum AbortKind : uint8_t { ABORT_STOP, ABORT_FLUSH, ABORT_REST };
+
+volatile uint8_t abortKind = ABORT_STOP;  // written before abortSerial
+volatile uint8_t abortTail = 0;           // planQueue.tail when it was requested
+std::atomic<uint8_t> abortSerial{0};      // bumped by ingest per request
+
+void requestAbort(AbortKind kind);
+
+// ================================
+// SYNCHRONIZED START
+// ================================
+// A two-handed sign is sent to both arms with FRAME_FLAG_SYNC (JSON
+// "sync": true). Each arm parses it ahead of time as usual, but when the plan
+// reaches the front it prints "READY <seq>" and holds. The host answers both
+// arms with "!GO <seq> <ms>", a start time on each arm's own millis() clock
+// that it derives from "!PING <n>" / "PONG <n> <ms>" round trips, so the two
+// arms start together however far apart the GO lines arrive.
+//
+// With SYNC_TRIGGER_PIN set, the arms instead share an open-drain line: each
+// drives it low except while holding a synced plan, so it only reads high
+// once both are ready, and both start on that edge. GO is then ignored.
+//
+// Control lines start with CONTROL_PREFIX and are answered as they arrive,
+// ahead of queued commands and even while the queue is full, so a PONG
+// timestamp is never delayed by a parse.
+std::atomic<uint8_t> syncGoSeq{0};     // seq the last GO was for (ingest writes)
+volatile uint32_t syncGoAtMs = 0;      // its start time, written before syncGoSeq
+bool syncWaiting = false;              // motion is holding a synced plan
+uint32_t syncReadyMs = 0;
+uint32_t syncReleasedMs = 0;           // trigger line released after a start
+bool syncHolding = false;
+volatile uint32_t idleRestMs = IDLE_REST_MS;  // "!IDLE <ms>" (see IDLE REST)
+
+void handleControlLine() {
+  controlLine[controlLength] = '\0';
+  if (strncmp(controlLine, "PING ", 5) == 0) {
+    baudUnconfirmed = false;
+    Serial.printf("PONG %s %lu\n", controlLine + 5, (unsigned long)millis());
+  } else if (strncmp(controlLine, "STATS", 5) == 0) {
+    printStats();
+    if (strcmp(controlLine + 5, " CLEAR") == 0) stats = Stats();
+  } else if (strncmp(controlLine, "BAUD ", 5) == 0) {
+    proposeBaud(strtoul(controlLine + 5, nullptr, 10));
+  } else if (strcmp(controlLine, "STOP") == 0) {
+    requestAbort(ABORT_STOP);
+  } else if (strcmp(controlLine, "FLUSH") == 0) {
+    requestAbort(ABORT_FLUSH);
+  } else if (strcmp(controlLine, "REST") == 0) {
+    requestAbort(ABORT_REST);
+  } else if (strncmp(controlLine, "IDLE ", 5) == 0) {
+    idleRestMs = strtoul(controlLine + 5, nullptr, 10);
+    Serial.printf("IDLE %lu\n", (unsigned long)idleRestMs);
+  } else if (strncmp(controlLine, "GO ", 3) == 0) {
+    char *end;
+    uint8_t seq = strtol(controlLine + 3, &end, 10);
+    syncGoAtMs = strtoul(end, nullptr, 10);
+    syncGoSeq.store(seq, std::memory_order_release);
+  } else {
+    Serial.printf(ARM_TAG "⚠ Unknown control line: %s\n", controlLine);
+  }
+}
+
+// ================================
+// QUEUE HELPERS
+// ================================
+// Occupied slots up or down by delta (ingest side only, so no read-modify-write)
+void countQueued(int delta) {
+  int queued = queueCount.load(std::memory_order_relaxed) + delta;
+  queueCount.store(queued, std::memory_order_relaxed);
+  stats.queueHighWater = max(stats.queueHighWater, queued);
+}
+
+// Publish the tail slot once its terminating '\n' has arrived
+void commitCommand() {
+  CommandSlot &slot = commandQueue[queueTail];
+  while (rxLength > 0 && isspace((unsigned char)slot.data[rxLength - 1])) rxLength--;
+  if (rxLength == 0) return;
+
+  slot.length = rxLength;
+  slot.receivedUs = micros();
+  queueTail = (queueTail + 1) % MAX_QUEUE;
+  countQueued(1);
+  Serial.printf(ARM_TAG "Command queued\n");
+}
+
+void releaseCommand() {
+  queueHead = (queueHead + 1) % MAX_QUEUE;
+  countQueued(-1);
+}
+
+void resetReceive() {
+  rxLength = 0;
+  rxDiscarding = false;
+  rxBinary = false;
+  rxFrameLength = 0;
+}
+
+// One byte of a binary frame: header first, then exactly payload + CRC
+void receiveFrameByte(uint8_t c) {
+  if (rxLength < FRAME_HEADER_SIZE) rxHeader[rxLength] = c;
+  if (!rxDiscarding) commandQueue[queueTail].data[rxLength] = (char)c;
+  rxLength++;
+
+  if (rxLength == FRAME_HEADER_SIZE) {
+    rxFrameLength = FRAME_HEADER_SIZE + (rxHeader[1] | (rxHeader[2] << 8)) + FRAME_CRC_SIZE;
+    if (!rxDiscarding && rxFrameLength > CMD_SLOT_SIZE) {
+      Serial.printf(ARM_TAG "❌ Frame too long, discarding\n");
+      stats.bad++;
+      rxDiscarding = true;
+    }
+  }
+
+  if (rxFrameLength > 0 && rxLength == rxFrameLength) {
+    if (!rxDiscarding) {
+      commandQueue[queueTail].length = rxLength;
+      commandQueue[queueTail].receivedUs = micros();
+      queueTail = (queueTail + 1) % MAX_QUEUE;
+      countQueued(1);
+      Serial.printf(ARM_TAG "Command queued\n");
+    }
+    resetReceive();
+  }
+}
+
+// Pull whatever bytes have arrived into the tail slot (non-blocking).
+// A command that starts while every slot is taken is rejected with "BUSY"
+// so the host knows it was dropped and stops sending until credits return.
+void receiveSerial() {
+  if (baudUnconfirmed && millis() - baudSwitchedMs > BAUD_CONFIRM_MS) {
+    switchBaud(BAUD_RATE);
+    resetReceive();  // whatever arrived was at the wrong rate
+    rxControl = false;
+    Serial.printf(ARM_TAG "⚠ Baud change not confirmed, back to boot rate\n");
+  }
+
+  unsigned long now = micros();
+  if (rxBinary && now - lastRxUs > FRAME_TIMEOUT_US) {
+    Serial.printf(ARM_TAG "❌ Incomplete frame, discarding\n");
+    stats.bad++;
+    resetReceive();
+  }
+
+  while (Serial.available()) {
+    char c = (char)Serial.read();
+    lastRxUs = now;
+
+    if (rxBinary) {
+      receiveFrameByte((uint8_t)c);
+      continue;
+    }
+
+    if (rxControl) {
+      if (c == '\n') {
+        handleControlLine();
+        rxControl = false;
+      } else if (controlLength < CONTROL_LINE_SIZE - 1 && c != '\r') {
+        controlLine[controlLength++] = c;
+      }
+      continue;
+    }
+
+    if (c == '\n') {
+      if (!rxDiscarding) commitCommand();
+      rxLength = 0;
+      rxDiscarding = false;
+      continue;
+    }
+    if (rxDiscarding) continue;
+
+    if (rxLength == 0) {
+      if (isspace((unsigned char)c)) continue;
+      if (c == CONTROL_PREFIX) {
+        rxControl = true;
+        controlLength = 0;
+        continue;
+      }
+      bool full = queueCount.load(std::memory_order_relaxed) >= MAX_QUEUE;
+      if (full) {
+        Serial.printf("BUSY\n");
+        stats.busy++;
+        rxDiscarding = true;
+      }
+      if ((uint8_t)c == FRAME_MAGIC) {
+        rxBinary = true;
+        receiveFrameByte((uint8_t)c);
+        continue;
+      }
+      if (full) continue;
+    }
+    if (rxLength >= CMD_SLOT_SIZE) {
+      Serial.printf(ARM_TAG "❌ Command too long, discarding\n");
+      stats.bad++;
+      rxDiscarding = true;
+      continue;
+    }
+    commandQueue[queueTail].data[rxLength++] = c;
+  }
+}
+
+// ================================
+// MOTION PLAN
+// ================================
+// A parsed motion command. Keyframes are decoded once, up front, so the
+// motion engine below never touches JSON while the arm is moving.
+struct Keyframe {
+  float time;  // seconds from sign start
+  uint16_t servo[TOTAL_SERVO_COUNT];  // target, tenths of a degree, by channel
+  ServoMask servoMask;               // channels this keyframe moves; the rest hold
+  bool hasShoulder;
+  long rotationSteps;
+  long elevationSteps;
+};
+
+struct MotionPlan {
+  char token[MAX_TOKEN_LEN];
+  uint8_t seq;    // host sequence number echoed in STARTED/DONE; 0 = none (plain ACK)
+  float duration;
+  bool timed;     // honor keyframe "time" stamps (see DEFAULT_TIMING)
+  bool streamed;  // keyframes keep arriving after the plan starts (see STREAMING)
+  bool held;      // wait for GO / the trigger line before starting (see SYNCHRONIZED START)
+  bool fineServos;  // binary keyframes carry tenths of a degree (FRAME_FLAG_FINE)
+  bool sampled;     // keyframes are precompiled setpoints, written as they fall due
+  std::atomic<int> frameCount{0};   // may exceed MAX_KEYFRAMES when streamed
+  std::atomic<int> framesReady{0};  // keyframes written so far (ingest side)
+  std::atomic<int> framesDone{0};   // keyframes motion no longer needs (motion side)
+  unsigned long publishedUs;        // when ingest handed it to motion (see STATISTICS)
+  Keyframe frames[MAX_KEYFRAMES];   // a ring for streamed plans; use frameAt()
+
+  Keyframe &frameAt(int index) { return frames[index % MAX_KEYFRAMES]; }
+};
+
+// Mark a fully parsed (non-streamed) plan as ready to run
+void sealPlan(MotionPlan &plan) {
+  plan.streamed = false;
+  plan.framesReady.store(plan.frameCount, std::memory_order_relaxed);
+  plan.framesDone.store(0, std::memory_order_relaxed);
+}
+
+void copyPlan(MotionPlan &dst, MotionPlan &src) {
+  memcpy(dst.token, src.token, sizeof(dst.token));
+  dst.seq = src.seq;
+  dst.duration = src.duration;
+  dst.timed = src.timed;
+  dst.sampled = src.sampled;
+  dst.frameCount = src.frameCount.load();
+  memcpy(dst.frames, src.frames, sizeof(Keyframe) * min((int)src.frameCount, MAX_KEYFRAMES));
+  sealPlan(dst);
+}
+
+// Lock-free single-producer / single-consumer ring between the ingest side
+// (parses into the tail slot, then publishes it) and the motion side (runs
+// the head slot in place, then releases it). Each index is written by one
+// side only; acquire/release ordering makes a published plan fully visible.
+struct PlanQueue {
+  MotionPlan slots[PLAN_QUEUE_SIZE];
+  std::atomic<uint8_t> head{0};  // written by motion
+  std::atomic<uint8_t> tail{0};  // written by ingest
+
+  // Ingest: slot to parse into, or nullptr when the motion side is behind
+  MotionPlan *back() {
+    uint8_t t = tail.load(std::memory_order_relaxed);
+    if ((t + 1) % PLAN_QUEUE_SIZE == head.load(std::memory_order_acquire)) return nullptr;
+    return &slots[t];
+  }
+  void publish() {
+    uint8_t t = tail.load(std::memory_order_relaxed);
+    tail.store((t + 1) % PLAN_QUEUE_SIZE, std::memory_order_release);
+  }
+
+  // Motion: oldest published plan, or nullptr when empty
+  MotionPlan *front() {
+    uint8_t h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire)) return nullptr;
+    return &slots[h];
+  }
+  void pop() {
+    uint8_t h = head.load(std::memory_order_relaxed);
+    head.store((h + 1) % PLAN_QUEUE_SIZE, std::memory_order_release);
+  }
+
+  // Motion: the plan published after front(), or nullptr (lookahead)
+  MotionPlan *second() {
+    uint8_t h = (head.load(std::memory_order_relaxed) + 1) % PLAN_QUEUE_SIZE;
+    if (front() == nullptr || h == tail.load(std::memory_order_acquire)) return nullptr;
+    return &slots[h];
+  }
+};
+
+PlanQueue planQueue;
+MotionPlan *activePlan = nullptr;  // planQueue.front() while a plan runs
+
+// ================================
+// JSON PARSE ARENA
+// ================================
+// ArduinoJson 7 has no zero-copy mode and allocates its pools through an
+// Allocator, so the next best thing is one reused document whose allocator
+// bumps through a static buffer and is rewound before every parse: no heap,
+// no 2 KB document on the task stack, and no fragmentation over a session.
+class ArenaAllocator : public ArduinoJson::Allocator {
+ public:
+  void *allocate(size_t size) override {
+    size_t need = HEADER_SIZE + align(size);
+    if (used + need > JSON_ARENA_SIZE) return nullptr;  // parse fails with NoMemory
+    uint8_t *block = buffer + used + HEADER_SIZE;
+    *(size_t *)(block - HEADER_SIZE) = size;
+    used += need;
+    last = block;
+    return block;
+  }
+
+  void deallocate(void *) override {}  // everything goes at reset()
+
+  void *reallocate(void *ptr, size_t size) override {
+    if (ptr == nullptr) return allocate(size);
+    uint8_t *block = (uint8_t *)ptr;
+    size_t oldSize = *(size_t *)(block - HEADER_SIZE);
+
+    // Most reallocs grow or shrink the newest block: adjust it in place
+    if (block == last) {
+      size_t start = block - buffer;
+      if (start + align(size) > JSON_ARENA_SIZE) return nullptr;
+      used = start + align(size);
+      *(size_t *)(block - HEADER_SIZE) = size;
+      return block;
+    }
+
+    void *moved = allocate(size);
+    if (moved != nullptr) memcpy(moved, block, min(oldSize, size));
+    return moved;
+  }
+
+  void reset() {
+    used = 0;
+    last = nullptr;
+  }
+
+ private:
+  static constexpr size_t HEADER_SIZE = 8;  // block size, keeps 8-byte alignment
+  static size_t align(size_t size) { return (size + 7) & ~(size_t)7; }
+
+  alignas(8) uint8_t buffer[JSON_ARENA_SIZE];
+  size_t used = 0;
+  uint8_t *last = nullptr;
+};
+
+ArenaAllocator jsonArena;
+JsonDocument commandDoc(&jsonArena);
+
+// Only the fields this arm executes are kept; the other arm's keys are
+// skipped by the parser instead of being stored in the arena.
+//
+// Channels come either under this arm's keys (L/LW/LE/LS) or under the
+// side-neutral H/W/E/S, which motion_io uses once it has projected a script
+// onto one arm. Both spellings mean the same channel; the arm's own key wins
+// if a keyframe has both.
+#define NEUTRAL_HAND_KEY     "H"
+#define NEUTRAL_WRIST_KEY    "W"
+#define NEUTRAL_ELBOW_KEY    "E"
+#define NEUTRAL_SHOULDER_KEY "S"
+
+JsonDocument commandFilter;
+const char COMMAND_FILTER_FORMAT[] =  // filled in with this arm's keys
+    R"({"token":true,"seq":true,"sync":true,"duration":true,"timing":true,)"
+    R"("keyframes":[{"time":true,"%s":true,"%s":true,"%s":true,"%s":true,)"
+    R"(")" NEUTRAL_HAND_KEY R"(":true,")" NEUTRAL_WRIST_KEY R"(":true,")"
+    NEUTRAL_ELBOW_KEY R"(":true,")" NEUTRAL_SHOULDER_KEY R"(":true}]})";
+
+void buildCommandFilter() {
+  char json[sizeof(COMMAND_FILTER_FORMAT) + 16];
+  snprintf(json, sizeof(json), COMMAND_FILTER_FORMAT,
+           Arm::handKey, Arm::wristKey, Arm::elbowKey, Arm::shoulderKey);
+  deserializeJson(commandFilter, json);  // one heap allocation, at boot
+}
+
+// One channel's array in a keyframe, under either of its keys
+JsonArray channelArray(JsonObject frame, const char *armKey, const char *neutralKey) {
+  JsonArray values = frame[armKey];
+  return values.isNull() ? frame[neutralKey].as<JsonArray>() : values;
+}
+
+// Servo target from a JSON angle, fraction kept, limited to what a servo
+// can be commanded to
+uint16_t servoPosition(float degrees) {
+  return (uint16_t)constrain(lroundf(degrees * SERVO_SCALE), 0L, (long)SERVO_MAX_POS);
+}
+
+// Motor steps for a shoulder angle, in this arm's direction
+long shoulderSteps(float degrees, float stepsPerDeg) {
+  return Arm::shoulderDirection * (long)(degrees * stepsPerDeg);
+}
+
+// Keyframe servo target, clamped to the channel's travel (see CHANNEL LIMITS)
+uint16_t servoTarget(int channel, uint16_t position) {
+  uint16_t limited = (uint16_t)limitServo(channel, position);
+  if (limited != position) stats.clamped++;
+  return limited;
+}
+
+float limitDegrees(float degrees, float low, float high) {
+  if (degrees < low || degrees > high) stats.clamped++;
+  return constrain(degrees, low, high);
+}
+
+// Keyframe shoulder targets, each angle clamped to its axis's travel
+void setShoulderTarget(Keyframe &kf, float rotationDeg, float elevationDeg) {
+  rotationDeg  = limitDegrees(rotationDeg,  limits.rotationMinDeg,  limits.rotationMaxDeg);
+  elevationDeg = limitDegrees(elevationDeg, limits.elevationMinDeg, limits.elevationMaxDeg);
+  kf.rotationSteps  = shoulderSteps(rotationDeg,  Arm::rotationStepsPerDeg);
+  kf.elevationSteps = shoulderSteps(elevationDeg, Arm::elevationStepsPerDeg);
+  kf.hasShoulder = true;
+}
+
+// ================================
+// PARSE ONE JSON MOTION COMMAND
+// ================================
+bool parseJsonCommand(const char *json, size_t length, MotionPlan &plan) {
+
+  commandDoc.clear();
+  jsonArena.reset();
+  JsonDocument &doc = commandDoc;
+  DeserializationError err = deserializeJson(doc, json, length, DeserializationOption::Filter(commandFilter));
+
+  if (err) {
+    Serial.printf(ARM_TAG "❌ JSON Parse Error: %s\n", err.c_str());
+    return false;
+  }
+
+  const char* token = doc["token"] | "<unknown>";
+  strncpy(plan.token, token, MAX_TOKEN_LEN - 1);
+  plan.token[MAX_TOKEN_LEN - 1] = '\0';
+  plan.duration = doc["duration"] | 1.0f;
+  if (plan.seq == 0) plan.seq = doc["seq"] | 0;  // hand-typed lines may carry it inside
+  plan.held = doc["sync"] | false;
+
+  const char* timing = doc["timing"] | DEFAULT_TIMING;
+  plan.timed = strcmp(timing, "timed") == 0;
+  plan.sampled = false;
+
+  JsonArray keyframes = doc["keyframes"];
+  int frameCount = keyframes.size();
+
+  if (frameCount == 0) {
+    Serial.printf(ARM_TAG "⚠ No keyframes!\n");
+    return false;
+  }
+  if (frameCount > MAX_KEYFRAMES) {
+    Serial.printf(ARM_TAG "⚠ Too many keyframes, truncating to %d\n", MAX_KEYFRAMES);
+    frameCount = MAX_KEYFRAMES;
+  }
+
+  plan.frameCount = 0;
+  for (JsonObject frame : keyframes) {
+    if (plan.frameCount >= frameCount) break;
+    Keyframe &kf = plan.frames[plan.frameCount++];
+    kf.time = frame["time"] | 0.0f;
+    kf.servoMask = 0;
+    kf.hasShoulder = false;
+
+    // Extract hand array (L / R / H)
+    JsonArray hand = channelArray(frame, Arm::handKey, NEUTRAL_HAND_KEY);
+    if (!hand.isNull() && hand.size() == HAND_SERVO_COUNT) {
+      for (int i = 0; i < HAND_SERVO_COUNT; i++) {
+        kf.servo[SERVO_HAND + i] = servoTarget(SERVO_HAND + i, servoPosition(hand[i].as<float>()));
+      }
+      kf.servoMask |= HAND_MASK;
+    }
+
+    // Extract wrist array (LW / RW / W)
+    JsonArray wrist = channelArray(frame, Arm::wristKey, NEUTRAL_WRIST_KEY);
+    if (!wrist.isNull() && wrist.size() == WRIST_SERVO_COUNT) {
+      for (int i = 0; i < WRIST_SERVO_COUNT; i++) {
+        kf.servo[SERVO_WRIST + i] = servoTarget(SERVO_WRIST + i, servoPosition(wrist[i].as<float>()));
+      }
+      kf.servoMask |= WRIST_MASK;
+    }
+
+    // Extract elbow array (LE / RE / E)
+    JsonArray elbow = channelArray(frame, Arm::elbowKey, NEUTRAL_ELBOW_KEY);
+    if (!elbow.isNull() && elbow.size() == ELBOW_SERVO_COUNT) {
+      for (int i = 0; i < ELBOW_SERVO_COUNT; i++) {
+        kf.servo[SERVO_ELBOW + i] = servoTarget(SERVO_ELBOW + i, servoPosition(elbow[i].as<float>()));
+      }
+      kf.servoMask |= ELBOW_MASK;
+    }
+
+    // Extract shoulder array (LS / RS / S): [rotation_deg, elevation_deg]
+    JsonArray shoulder = channelArray(frame, Arm::shoulderKey, NEUTRAL_SHOULDER_KEY);
+    if (!shoulder.isNull() && shoulder.size() == 2) {
+      setShoulderTarget(kf, shoulder[0].as<float>(), shoulder[1].as<float>());
+    }
+  }
+
+  sealPlan(plan);
+  return true;
+}
+
+// ================================
+// BINARY FRAME PROTOCOL
+// ================================
+// Compact alternative to JSON for the hot path (~10x fewer bytes, no parse).
+// All multi-byte fields are little-endian.
+//
+//   magic   uint8   FRAME_MAGIC
+//   length  uint16  payload bytes
+//   payload (FRAME_TYPE_MOTION):
+//     type      uint8   FRAME_TYPE_MOTION
+//     seq       uint8   host sequence number (see FLOW CONTROL)
+//     flags     uint8   FRAME_FLAG_TIMED | FRAME_FLAG_SYNC | FRAME_FLAG_FINE |
+//                       FRAME_FLAG_SAMPLED
+//     duration  uint16  ms
+//     tokenLen  uint8, then tokenLen bytes (not NUL-terminated)
+//     count     uint8   keyframes, each:
+//       time    uint16  ms
+//       mask    uint8   bit0 hand, bit1 wrist, bit2 elbow, bit3 shoulder
+//       hand    5 x uint8   degrees       (if bit0)
+//       wrist   2 x uint8   degrees       (if bit1)
+//       elbow   1 x uint8   degrees       (if bit2)
+//               (uint16 tenths of a degree instead with FRAME_FLAG_FINE)
+//       shoulder 2 x int16  centi-degrees (if bit3) [rotation, elevation]
+//   crc     uint16  CRC-16/CCITT-FALSE over payload
+//
+// Frames carry this arm's channels only; absent groups hold, as in JSON.
+//
+//   payload (FRAME_TYPE_STORE): type, id uint8, then flags..keyframes as above
+//   payload (FRAME_TYPE_PLAY):  type, seq, id uint8
+//   payload (FRAME_TYPE_STREAM_BEGIN): type, seq, flags, duration, tokenLen +
+//                                      token, count uint16 (total keyframes)
+//   payload (FRAME_TYPE_STREAM_KEYS):  type, count uint8, then keyframes as above
+#define CHANNEL_HAND     0x01
+#define CHANNEL_WRIST    0x02
+#define CHANNEL_ELBOW    0x04
+#define CHANNEL_SHOULDER 0x08
+
+uint16_t crc16Ccitt(const uint8_t *data, size_t length) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+// Bounds-checked little-endian reader over a frame payload
+struct FrameReader {
+  const uint8_t *data;
+  size_t length;
+  size_t pos;
+  bool ok;
+
+  uint8_t u8() {
+    if (pos + 1 > length) { ok = false; return 0; }
+    return data[pos++];
+  }
+  uint16_t u16() {
+    if (pos + 2 > length) { ok = false; return 0; }
+    uint16_t v = data[pos] | (data[pos + 1] << 8);
+    pos += 2;
+    return v;
+  }
+  int16_t i16() { return (int16_t)u16(); }
+};
+
+// Read flags, duration and token of a motion or stream header
+void readPlanHeader(FrameReader &in, MotionPlan &plan) {
+  uint8_t flags = in.u8();
+  plan.sampled = (flags & FRAME_FLAG_SAMPLED) != 0;
+  plan.timed = (flags & (FRAME_FLAG_TIMED | FRAME_FLAG_SAMPLED)) != 0;
+  plan.held = (flags & FRAME_FLAG_SYNC) != 0;
+  plan.fineServos = (flags & FRAME_FLAG_FINE) != 0;
+  plan.duration = in.u16() / 1000.0f;
+
+  uint8_t tokenLength = in.u8();
+  size_t copied = min((size_t)tokenLength, (size_t)(MAX_TOKEN_LEN - 1));
+  if (in.pos + tokenLength > in.length) in.ok = false;
+  if (in.ok) {
+    memcpy(plan.token, in.data + in.pos, copied);
+    in.pos += tokenLength;
+  } else {
+    copied = 0;
+  }
+  plan.token[copied] = '\0';
+}
+
+// Servo fields are whole degrees, or tenths with FRAME_FLAG_FINE (`fine`)
+void readKeyframe(FrameReader &in, Keyframe &kf, bool fine) {
+  kf.time = in.u16() / 1000.0f;
+  uint8_t mask = in.u8();
+
+  kf.servoMask = ((mask & CHANNEL_HAND)  ? HAND_MASK  : 0) |
+                 ((mask & CHANNEL_WRIST) ? WRIST_MASK : 0) |
+                 ((mask & CHANNEL_ELBOW) ? ELBOW_MASK : 0);
+  kf.hasShoulder = (mask & CHANNEL_SHOULDER) != 0;
+
+  // Channels are stored in the same order as the frame's hand, wrist, elbow fields
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    if (!(kf.servoMask & (1u << i))) continue;
+    kf.servo[i] = servoTarget(i, fine ? in.u16() : in.u8() * SERVO_SCALE);
+  }
+  if (kf.hasShoulder) {
+    float rotationDeg  = in.i16() / 100.0f;
+    float elevationDeg = in.i16() / 100.0f;
+    setShoulderTarget(kf, rotationDeg, elevationDeg);
+  }
+}
+
+// Read flags..keyframes of a motion payload (after the type/id bytes)
+bool readMotionPayload(FrameReader &in, MotionPlan &plan) {
+  readPlanHeader(in, plan);
+
+  int frameCount = in.u8();
+  if (in.ok && frameCount == 0) {
+    Serial.printf(ARM_TAG "⚠ No keyframes!\n");
+    return false;
+  }
+  if (frameCount > MAX_KEYFRAMES) {
+    Serial.printf(ARM_TAG "⚠ Too many keyframes, truncating to %d\n", MAX_KEYFRAMES);
+    frameCount = MAX_KEYFRAMES;
+  }
+
+  int read = 0;
+  while (in.ok && read < frameCount) {
+    readKeyframe(in, plan.frames[read++], plan.fineServos);
+  }
+  plan.frameCount = read;
+
+  if (!in.ok) {
+    Serial.printf(ARM_TAG "❌ Truncated frame\n");
+    return false;
+  }
+  sealPlan(plan);
+  return true;
+}
+
+// ================================
+// STREAMING
+// ================================
+// A sign with more keyframes than a plan holds is sent as a STREAM_BEGIN
+// header followed by STREAM_KEYS chunks. The plan is published as soon as
+// the header arrives and starts moving once keyframe 0 lands, while later
+// chunks are written into frames[] as a ring — never more than
+// MAX_KEYFRAMES ahead of the keyframe being executed, so memory use does not
+// grow with sign length. Each absorbed chunk is answered with "NEXT", which
+// the host uses to pace the rest; a chunk that doesn't fit yet simply stays
+// in its command slot until the motion side frees room.
+MotionPlan *streamPlan = nullptr;  // ingest side: plan still receiving keyframes
+
+// Stop waiting for the rest of the current stream and play what arrived.
+// A stream cut off before its first chunk is left with no keyframes at all;
+// the motion side rejects it when it reaches the front (see startPlan).
+void truncateStream() {
+  if (streamPlan == nullptr) return;
+  Serial.printf(ARM_TAG "⚠ Stream interrupted, truncating sign\n");
+  streamPlan->frameCount = streamPlan->framesReady.load(std::memory_order_relaxed);
+  streamPlan = nullptr;
+}
+
+bool beginStream(FrameReader &in, MotionPlan &plan) {
+  truncateStream();
+  readPlanHeader(in, plan);
+  int frameCount = in.u16();
+  if (!in.ok) {
+    Serial.printf(ARM_TAG "❌ Truncated frame\n");
+    return false;
+  }
+  if (frameCount == 0) {
+    Serial.printf(ARM_TAG "⚠ No keyframes!\n");
+    return false;
+  }
+
+  plan.streamed = true;
+  plan.frameCount = frameCount;
+  plan.framesReady.store(0, std::memory_order_relaxed);
+  plan.framesDone.store(0, std::memory_order_relaxed);
+  streamPlan = &plan;
+  return true;
+}
+
+// Returns false when the chunk doesn't fit yet and should be retried
+bool appendStream(FrameReader &in) {
+  if (streamPlan == nullptr) {
+    Serial.printf(ARM_TAG "⚠ Keyframe chunk without a stream, discarding\n");
+    return true;
+  }
+
+  int count = in.u8();
+  int next = streamPlan->framesReady.load(std::memory_order_relaxed);
+  if (count > STREAM_CHUNK_MAX || next + count > streamPlan->frameCount) {
+    Serial.printf(ARM_TAG "❌ Bad keyframe chunk\n");
+    truncateStream();
+    return true;
+  }
+  if (next + count > streamPlan->framesDone.load(std::memory_order_acquire) + MAX_KEYFRAMES) {
+    return false;  // would overwrite keyframes still in use
+  }
+
+  for (int i = 0; i < count && in.ok; i++) {
+    readKeyframe(in, streamPlan->frameAt(next + i), streamPlan->fineServos);
+  }
+  if (!in.ok) {
+    Serial.printf(ARM_TAG "❌ Truncated frame\n");
+    truncateStream();
+    return true;
+  }
+
+  streamPlan->framesReady.store(next + count, std::memory_order_release);
+  Serial.printf("NEXT\n");
+  if (next + count == streamPlan->frameCount) streamPlan = nullptr;
+  return true;
+}
+
+// Ingest side of a priority command (see PRIORITY COMMANDS). Runs between
+// commands, so no slot is half parsed and the tail slot holds no bytes yet.
+void requestAbort(AbortKind kind) {
+  queueHead = queueTail;
+  queueCount.store(0, std::memory_order_relaxed);
+  truncateStream();
+  abortKind = kind;
+  abortTail = planQueue.tail.load(std::memory_order_relaxed);
+  abortSerial.store(abortSerial.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// ================================
+// SIGN CACHE
+// ================================
+// Fingerspelling letters and the rest pose never change, so the host uploads
+// them once per boot (FRAME_TYPE_STORE) and then sends a 7-byte PLAY frame
+// instead of the whole motion. Entries are kept parsed, so a PLAY is a plan
+// copy with no decode. The cache is RAM only: the host re-uploads on every
+// connect, which also keeps it in step with the Python sign tables.
+MotionPlan signCache[SIGN_CACHE_SIZE];
+bool signCached[SIGN_CACHE_SIZE];
+
+// Rest pose (REST_LEFT / REST_RIGHT in rest_cache.py): all servos 90°, shoulders home
+void bakeRestPose() {
+  MotionPlan &rest = signCache[SIGN_ID_REST];
+  strncpy(rest.token, Arm::restToken, MAX_TOKEN_LEN - 1);
+  rest.token[MAX_TOKEN_LEN - 1] = '\0';
+  rest.duration = 0.5f;
+  rest.timed = true;
+  rest.frameCount = 1;
+
+  Keyframe &kf = rest.frames[0];
+  kf.time = 0.0f;
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) kf.servo[i] = 90 * SERVO_SCALE;
+  kf.servoMask = HAND_MASK | WRIST_MASK | ELBOW_MASK;
+  kf.rotationSteps  = 0;
+  kf.elevationSteps = 0;
+  kf.hasShoulder = true;
+
+  signCached[SIGN_ID_REST] = true;
+}
+
+void storeSign(FrameReader &in) {
+  uint8_t id = in.u8();
+  if (id == SIGN_ID_REST || id >= SIGN_CACHE_SIZE) {
+    Serial.printf(ARM_TAG "❌ Bad sign cache id %u\n", id);
+    return;
+  }
+  signCached[id] = false;
+  if (!readMotionPayload(in, signCache[id])) return;
+  signCached[id] = true;
+
+  Serial.printf("STORED %u\n", id);
+}
+
+bool playSign(int id, MotionPlan &plan) {
+  if (id < 0 || id >= SIGN_CACHE_SIZE || !signCached[id]) {
+    Serial.printf(ARM_TAG "❌ Sign not cached: %d\n", id);
+    return false;
+  }
+  copyPlan(plan, signCache[id]);
+  plan.held = false;  // cached signs always start on their own
+  return true;
+}
+
+// ================================
+// FLOW CONTROL
+// ================================
+// Every sign the host sends carries a sequence number (binary header byte,
+// "<seq> {json}", or "PLAY <id> <seq>"; a "seq" field inside hand-typed JSON
+// works too). The firmware echoes it:
+//
+//   STARTED <seq> <credits>   plan began executing
+//   DONE <seq> <credits>      plan finished
+//   REJECTED <seq>            command failed to parse and will not run
+//
+// <credits> is the number of free command slots, which the host uses to keep
+// several commands in flight without ever hitting BUSY. Commands without a
+// sequence number (seq 0, e.g. hand-typed JSON) get the plain "ACK" instead.
+int freeCredits() { return MAX_QUEUE - queueCount.load(std::memory_order_relaxed); }
+
+void reportPlanEvent(const char *event, uint8_t seq) {
+  Serial.printf("%s %u %d\n", event, seq, freeCredits());
+}
+
+// counter is stats.rejected from ingest, stats.cutStreams from motion, so
+// each stays single-writer
+void reportRejected(uint8_t seq, uint32_t &counter = stats.rejected) {
+  counter++;
+  if (seq != 0) Serial.printf("REJECTED %u\n", seq);
+}
+
+// Outcome of parsing one queued command
+enum ParseResult {
+  PARSE_DROP,   // consumed, nothing to execute (error, cache upload, stream chunk)
+  PARSE_PLAN,   // a plan was written and should be published
+  PARSE_RETRY,  // can't be handled yet; leave it queued
+};
+
+ParseResult planResult(bool ok) { return ok ? PARSE_PLAN : PARSE_DROP; }
+
+ParseResult parseBinaryCommand(const uint8_t *frame, size_t length, MotionPlan *plan) {
+  size_t payloadLength = frame[1] | (frame[2] << 8);
+  const uint8_t *payload = frame + FRAME_HEADER_SIZE;
+  if (length != FRAME_HEADER_SIZE + payloadLength + FRAME_CRC_SIZE) {
+    Serial.printf(ARM_TAG "❌ Truncated frame\n");
+    stats.bad++;
+    return PARSE_DROP;
+  }
+  uint16_t crc = payload[payloadLength] | (payload[payloadLength + 1] << 8);
+
+  if (crc16Ccitt(payload, payloadLength) != crc) {
+    Serial.printf(ARM_TAG "❌ Frame CRC mismatch\n");
+    stats.bad++;
+    return PARSE_DROP;
+  }
+
+  FrameReader in = {payload, payloadLength, 0, true};
+  uint8_t type = in.u8();
+
+  // Commands that don't need a plan slot
+  if (type == FRAME_TYPE_STORE) {
+    storeSign(in);
+    return PARSE_DROP;
+  }
+  if (type == FRAME_TYPE_STREAM_KEYS) {
+    return appendStream(in) ? PARSE_DROP : PARSE_RETRY;
+  }
+
+  if (plan == nullptr) return PARSE_RETRY;  // plan queue full
+  if (type == FRAME_TYPE_MOTION || type == FRAME_TYPE_PLAY) {
+    truncateStream();  // a new sign ends any stream still in progress
+  }
+
+  uint8_t seq = in.u8();
+  bool ok;
+  switch (type) {
+    case FRAME_TYPE_MOTION:
+      ok = readMotionPayload(in, *plan);
+      break;
+    case FRAME_TYPE_PLAY: {
+      uint8_t id = in.u8();
+      ok = in.ok && playSign(id, *plan);
+      break;
+    }
+    case FRAME_TYPE_STREAM_BEGIN:
+      ok = beginStream(in, *plan);
+      break;
+    default:
+      Serial.printf(ARM_TAG "❌ Unknown frame type\n");
+      return PARSE_DROP;
+  }
+
+  if (!ok) {
+    reportRejected(seq);
+    return PARSE_DROP;
+  }
+  plan->seq = seq;
+  return PARSE_PLAN;
+}
+
+// Parse one queued command into `plan` (nullptr when the plan queue is full).
+// Accepts a binary frame, a "PLAY <id>" line (handy from the serial monitor)
+// or a JSON line.
+ParseResult parseCommand(const CommandSlot &slot, MotionPlan *plan) {
+  if ((uint8_t)slot.data[0] == FRAME_MAGIC) {
+    return parseBinaryCommand((const uint8_t *)slot.data, slot.length, plan);
+  }
+  if (plan == nullptr) return PARSE_RETRY;
+  truncateStream();  // a new sign ends any stream still in progress
+  if (strncmp(slot.data, "PLAY ", 5) == 0) {
+    char *end;
+    int id = strtol(slot.data + 5, &end, 10);
+    uint8_t seq = strtol(end, nullptr, 10);
+    if (!playSign(id, *plan)) {
+      reportRejected(seq);
+      return PARSE_DROP;
+    }
+    plan->seq = seq;
+    return PARSE_PLAN;
+  }
+  // "<seq> {...}": the seq rides in front of the JSON, as in "PLAY <id> <seq>",
+  // so a line whose JSON is broken can still be REJECTED by number
+  size_t start = 0;
+  uint8_t seq = 0;
+  while (start < slot.length && isdigit((unsigned char)slot.data[start])) {
+    seq = seq * 10 + (slot.data[start++] - '0');
+  }
+  while (start < slot.length && slot.data[start] == ' ') start++;
+  plan->seq = seq;
+  bool ok = parseJsonCommand(slot.data + start, slot.length - start, *plan);
+  if (!ok) reportRejected(plan->seq);
+  return planResult(ok);
+}
+
+// ================================
+// MOTION ENGINE (non-blocking)
+// ================================
+// updateMotion() is called on every motion-task pass and returns immediately.
+// The steppers are run() on every pass; servos are updated once per
+// DEFAULT_STEP_DELAY.
+//
+// Step timing: servos advance along their trapezoidal profiles; once all
+// joints reach the keyframe the engine dwells for duration / frameCount, as
+// the blocking version did.
+//
+// Timed playback: each keyframe is a segment of time[N] - time[N-1]
+// seconds. Servos are interpolated linearly across it and the steppers get
+// a peak speed that lands them on the target at the segment's end. The move
+// into keyframe 0 (time 0.0) takes as long as the slowest profile needs, and the last
+// keyframe is held until "duration", so a sign takes lead-in + duration.
+// With BLEND_SIGNS a queued successor's lead-in starts when that hold ends
+// (see BLENDING).
+enum MotionPhase { MOTION_IDLE, MOTION_MOVING, MOTION_DWELL };
+
+MotionPhase motionPhase = MOTION_IDLE;
+int activeFrame = 0;
+unsigned long frameTimeUs    = 0;   // step timing: dwell after each keyframe
+unsigned long lastServoStepUs = 0;
+unsigned long dwellStartUs    = 0;
+unsigned long segmentStartUs    = 0;  // timed playback: current segment
+unsigned long segmentDurationUs = 0;
+bool streamStarved = false;  // waiting on a streamed keyframe that hasn't arrived
+bool segmentBlended = false;  // timed segment is a blend between two signs
+bool samplePlayback = false;  // sampled plan past its lead-in (see SAMPLED PLAYBACK)
+unsigned long lastPassUs = 0;  // previous updateMotion() pass while a plan ran (STATS loop)
+
+// ================================
+// IDLE REST
+// ================================
+// An arm that has had no command for idleRestMs after a sign glides to the
+// baked rest pose (SIGN_ID_REST) by itself, so the host never has to send a
+// rest to the arm a sign leaves out. The rest runs outside the plan queue
+// and reports nothing: no STARTED/DONE/ACK and no credits. It is abandoned
+// the moment a command is published, and that sign picks the servos up
+// from wherever the rest left them (the shoulders keep heading home until
+// a keyframe retargets them). Held and half-streamed plans sit at the front
+// of the queue, so an arm waiting on GO or a first chunk never rests.
+MotionPlan idleRestPlan;     // motion's own copy of the rest pose
+bool idleResting = false;    // activePlan is idleRestPlan
+bool idleRestDue = false;    // the last plan left the arm away from rest
+uint32_t idleSinceMs = 0;    // when that plan finished
+
+// ================================
+// JOINT TABLE
+// ================================
+// Servo state as parallel arrays indexed by channel, updated in one pass
+// over every channel. A pass only records which channels changed (dirty);
+// flushServos() then writes just those to the PWM peripheral, so a joint
+// that is holding or already on target costs no write. Flushes are at most
+// one PWM period apart: a servo only samples one pulse per period, so
+// writing more often changes nothing, and channels flushed together switch
+// on the same period (see SERVO OUTPUT). The shoulder axes keep their own
+// position and speed in the step generator.
+struct JointTable {
+  int position[TOTAL_SERVO_COUNT];  // last commanded tenths of a degree; persists across commands
+  int start[TOTAL_SERVO_COUNT];     // positions at the start of the timed segment
+  float profilePosition[TOTAL_SERVO_COUNT];  // step timing: unrounded profile state
+  float velocity[TOTAL_SERVO_COUNT];         //   (tenths of a degree, per second)
+  float startTangent[TOTAL_SERVO_COUNT];  // blend segments: velocity x duration at each end
+  float endTangent[TOTAL_SERVO_COUNT];
+  ServoMask dirty;                  // channels changed since the last flush
+};
+
+JointTable joints = {{900, 900, 900, 900, 900, 900, 900, 900}, {}, {}, {}, {}, {}, 0};
+static_assert(TOTAL_SERVO_COUNT == 8, "joints initializer lists every channel");
+unsigned long lastServoFlushUs = 0;
+
+void flushServos() {
+  ServoMask dirty = joints.dirty;
+  joints.dirty = 0;
+  for (int i = 0; dirty != 0; i++, dirty >>= 1) {
+    if (dirty & 1) writeServo(i, joints.position[i]);
+  }
+}
+
+// ================================
+// SERVO PROFILES
+// ================================
+// Step-timed servo moves follow a trapezoidal velocity profile per channel,
+// like AccelStepper does for the shoulders: accelerate at the joint class's
+// limit, cruise at its top speed, and decelerate to land on the target.
+// The profile is advanced incrementally on every control tick, so the
+// fingers no longer all jump to full speed at once (current spikes) and
+// peak speed can go up without overshoot.
+struct ServoLimits {
+  float maxSpeed;  // tenths of a degree per second
+  float accel;     // tenths of a degree per second²
+};
+
+#define SERVO_LIMITS(speed, accel) {(speed) * SERVO_SCALE, (accel) * SERVO_SCALE}
+const ServoLimits servoLimits[TOTAL_SERVO_COUNT] = {
+  SERVO_LIMITS(HAND_MAX_SPEED, HAND_ACCEL), SERVO_LIMITS(HAND_MAX_SPEED, HAND_ACCEL),
+  SERVO_LIMITS(HAND_MAX_SPEED, HAND_ACCEL), SERVO_LIMITS(HAND_MAX_SPEED, HAND_ACCEL),
+  SERVO_LIMITS(HAND_MAX_SPEED, HAND_ACCEL),
+  SERVO_LIMITS(WRIST_MAX_SPEED, WRIST_ACCEL), SERVO_LIMITS(WRIST_MAX_SPEED, WRIST_ACCEL),
+  SERVO_LIMITS(ELBOW_MAX_SPEED, ELBOW_ACCEL),
+};
+
+// Shortest time (s) for `channel` to travel `distance` tenths of a degree from rest to rest
+float servoMinTime(int channel, float distance) {
+  const ServoLimits &limits = servoLimits[channel];
+  float d = fabsf(distance);
+  float rampDistance = limits.maxSpeed * limits.maxSpeed / limits.accel;
+  if (d <= rampDistance) return 2.0f * sqrtf(d / limits.accel);
+  return d / limits.maxSpeed + limits.maxSpeed / limits.accel;
+}
+
+// Time (s) the slowest channel of kf needs to reach it from the current pose
+float servoMoveTime(const Keyframe &kf) {
+  float seconds = 0.0f;
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    if (kf.servoMask & (1u << i)) {
+      seconds = max(seconds, servoMinTime(i, kf.servo[i] - joints.position[i]));
+    }
+  }
+  return seconds;
+}
+
+// Restart every profile at rest from the commanded pose
+void resetServoProfiles() {
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    joints.profilePosition[i] = joints.position[i];
+    joints.velocity[i] = 0.0f;
+  }
+}
+
+// Advance every channel kf drives `dt` seconds along its profile. Returns
+// true while any of them is still moving.
+bool profileServos(const Keyframe &kf, float dt) {
+  ServoMask moving = 0, moved = 0;
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    if (!(kf.servoMask & (1u << i))) continue;
+    const ServoLimits &limits = servoLimits[i];
+    float &x = joints.profilePosition[i];
+    float &v = joints.velocity[i];
+    float error = kf.servo[i] - x;
+    if (error == 0.0f && v == 0.0f) continue;
+
+    // Fastest speed that can still stop on the target, reached within the
+    // acceleration limit
+    float wanted = copysignf(min(limits.maxSpeed, sqrtf(2.0f * limits.accel * fabsf(error))), error);
+    v += constrain(wanted - v, -limits.accel * dt, limits.accel * dt);
+    float step = v * dt;
+    if (step * error > 0.0f && fabsf(step) >= fabsf(error)) {
+      x = kf.servo[i];  // lands this tick
+      v = 0.0f;
+    } else {
+      x += step;
+    }
+    moving |= (ServoMask)1 << i;
+
+    int position = (int)lroundf(x);
+    moved |= (ServoMask)(position != joints.position[i]) << i;
+    joints.position[i] = position;
+  }
+  joints.dirty |= moved;
+  return moving != 0;
+}
+
+// Shortest time (s) for a stepper to travel `distance` steps from rest
+float stepperMinTime(long distance) {
+  float d = fabsf((float)distance);
+  float rampDistance = SHOULDER_MAX_SPEED * SHOULDER_MAX_SPEED / SHOULDER_ACCEL;
+  if (d <= rampDistance) return 2.0f * sqrtf(d / SHOULDER_ACCEL);
+  return d / SHOULDER_MAX_SPEED + SHOULDER_MAX_SPEED / SHOULDER_ACCEL;
+}
+
+// Peak speed (steps/s) that covers `distance` steps in `seconds` with
+// SHOULDER_ACCEL ramps: d = v*T - v^2/a. Falls back to SHOULDER_MAX_SPEED
+// when the move can't be made in time.
+float stepperSpeedFor(long distance, float seconds) {
+  float d = fabsf((float)distance);
+  if (d == 0.0f || seconds <= 0.0f) return SHOULDER_MAX_SPEED;
+  float aT = SHOULDER_ACCEL * seconds;
+  float disc = aT * aT - 4.0f * SHOULDER_ACCEL * d;
+  if (disc < 0.0f) return SHOULDER_MAX_SPEED;
+  float v = (aT - sqrtf(disc)) / 2.0f;
+  return constrain(v, 1.0f, SHOULDER_MAX_SPEED);
+}
+
+// Length of the timed segment that ends on keyframe `index`
+unsigned long timedSegmentUs(int index) {
+  const Keyframe &kf = activePlan->frameAt(index);
+  float seconds = (index == 0) ? kf.time : kf.time - activePlan->frameAt(index - 1).time;
+  if (seconds > 0.0f) return (unsigned long)(seconds * 1000000.0f);
+
+  // Lead-in (or a zero-length segment): as fast as the servo profiles allow
+  unsigned long leadInUs = (unsigned long)(servoMoveTime(kf) * 1000000.0f);
+
+  if (kf.hasShoulder) {
+    float stepperTime = max(stepperMinTime(kf.rotationSteps  - shoulderRotation.currentPosition()),
+                            stepperMinTime(kf.elevationSteps - shoulderFlexion.currentPosition()));
+    leadInUs = max(leadInUs, (unsigned long)(stepperTime * 1000000.0f));
+  }
+  return leadInUs;
+}
+
+void beginKeyframe(int index) {
+  activeFrame = index;
+  const Keyframe &kf = activePlan->frameAt(index);
+  // Timed segments still read the previous keyframe; everything older is free
+  activePlan->framesDone.store(max(index - 1, 0), std::memory_order_release);
+  unsigned long now = micros();
+
+  if (activePlan->timed) {
+    segmentStartUs = now;
+    segmentDurationUs = timedSegmentUs(index);
+    segmentBlended = false;
+    memcpy(joints.start, joints.position, sizeof(joints.start));
+  } else {
+    resetServoProfiles();
+  }
+
+  // Queue stepper targets (non-blocking — .run() advances in updateMotion)
+  if (kf.hasShoulder) {
+    if (activePlan->timed) {
+      float seconds = segmentDurationUs / 1000000.0f;
+      shoulderRotation.setMaxSpeed(stepperSpeedFor(kf.rotationSteps  - shoulderRotation.currentPosition(), seconds));
+      shoulderFlexion.setMaxSpeed(stepperSpeedFor(kf.elevationSteps - shoulderFlexion.currentPosition(),  seconds));
+    } else {
+      shoulderRotation.setMaxSpeed(SHOULDER_MAX_SPEED);
+      shoulderFlexion.setMaxSpeed(SHOULDER_MAX_SPEED);
+    }
+    shoulderRotation.moveTo(kf.rotationSteps);
+    shoulderFlexion.moveTo(kf.elevationSteps);
+  }
+
+  motionPhase = MOTION_MOVING;
+  lastServoStepUs = now;
+}
+
+// Whether keyframe activeFrame + 1 has arrived (only ever false when streamed)
+bool nextFrameReady() {
+  if (activePlan->framesReady.load(std::memory_order_acquire) > activeFrame + 1) {
+    streamStarved = false;
+    return true;
+  }
+  if (!streamStarved) {
+    Serial.printf(ARM_TAG "⚠ Stream underrun, holding pose\n");
+    streamStarved = true;
+  }
+  return false;
+}
+
+// Whether a held plan may start now. The first call reports READY.
+bool syncReleased(const MotionPlan &plan) {
+  uint32_t now = millis();
+  if (!syncWaiting) {
+    syncWaiting = true;
+    syncReadyMs = now;
+#if SYNC_TRIGGER_PIN >= 0
+    digitalWrite(SYNC_TRIGGER_PIN, HIGH);  // release: "this arm is ready"
+#endif
+    // The host sends GO only after READY, so anything latched now is stale: a
+    // GO that came after this arm started alone would release a later plan
+    // reusing the seq at once. Cleared before READY goes out, so the real GO
+    // can't be the one lost.
+    syncGoSeq.store(0, std::memory_order_relaxed);
+    Serial.printf("READY %u\n", plan.seq);
+  }
+
+#if SYNC_TRIGGER_PIN >= 0
+  bool go = digitalRead(SYNC_TRIGGER_PIN) == HIGH;
+#else
+  bool go = syncGoSeq.load(std::memory_order_acquire) == plan.seq &&
+            (int32_t)(now - syncGoAtMs) >= 0;
+#endif
+  if (!go) {
+    if (now - syncReadyMs < SYNC_TIMEOUT_MS) return false;
+    Serial.printf(ARM_TAG "⚠ No synchronized start, starting alone\n");
+  }
+
+  syncWaiting = false;
+  syncGoSeq.store(0, std::memory_order_relaxed);
+  syncReleasedMs = now;
+  syncHolding = true;
+  return true;
+}
+
+// Pull the trigger line low again once the other arm has had time to see it
+void updateSyncTrigger() {
+#if SYNC_TRIGGER_PIN >= 0
+  if (syncHolding && millis() - syncReleasedMs >= SYNC_TRIGGER_HOLD_MS) {
+    digitalWrite(SYNC_TRIGGER_PIN, LOW);
+    syncHolding = false;
+  }
+#endif
+}
+
+// Announce activePlan and move to its first keyframe
+void runPlan() {
+  streamStarved = false;
+  samplePlayback = false;
+
+  Serial.printf(ARM_TAG "Executing token: %s\n", activePlan->token);
+  if (activePlan->seq != 0) reportPlanEvent("STARTED", activePlan->seq);
+
+  frameTimeUs = (unsigned long)((activePlan->duration / activePlan->frameCount) * 1000000.0f);
+  beginKeyframe(0);
+  if (!idleResting) stats.start.record(micros() - activePlan->publishedUs);
+}
+
+void beginIdleRest() {
+  idleRestDue = false;
+  idleResting = true;
+  activePlan = &idleRestPlan;
+  runPlan();
+}
+
+// Start the idle rest once the arm has been idle long enough (see IDLE REST)
+void startIdleRest() {
+  uint32_t timeoutMs = idleRestMs;
+  if (!idleRestDue || timeoutMs == 0 || millis() - idleSinceMs < timeoutMs) return;
+  beginIdleRest();
+}
+
+// A command arrived during the idle rest: stop it where it is
+void cancelIdleRest() {
+  idleResting = false;
+  activePlan = nullptr;
+  motionPhase = MOTION_IDLE;
+}
+
+// Motion side of PRIORITY COMMANDS
+uint8_t abortsHandled = 0;   // abortSerial last acted on
+bool dropPending = false;    // plans up to dropTail go once the current one ends (FLUSH)
+uint8_t dropTail = 0;
+
+bool abortPending() {
+  return abortSerial.load(std::memory_order_acquire) != abortsHandled;
+}
+
+// Pop, unannounced, every plan published before the request
+void dropPlans() {
+  while (planQueue.front() != nullptr && planQueue.head.load(std::memory_order_relaxed) != dropTail) {
+    planQueue.pop();
+  }
+  dropPending = false;
+  syncWaiting = false;
+#if SYNC_TRIGGER_PIN >= 0
+  digitalWrite(SYNC_TRIGGER_PIN, LOW);  // no longer holding a synced plan
+#endif
+}
+
+// Leave the servos where they are and bring the shoulders to a stop
+void haltMotion() {
+  activePlan = nullptr;
+  idleResting = false;
+  idleRestDue = false;
+  streamStarved = false;
+  samplePlayback = false;
+  motionPhase = MOTION_IDLE;
+  shoulderRotation.stop();
+  shoulderFlexion.stop();
+}
+
+void handleAbort() {
+  abortsHandled = abortSerial.load(std::memory_order_acquire);
+  uint8_t kind = abortKind;
+  dropTail = abortTail;
+  dropPending = true;
+
+  if (kind == ABORT_FLUSH) {
+    if (activePlan == nullptr || idleResting) dropPlans();  // else once the current sign retires
+    Serial.printf("FLUSHED %d\n", freeCredits());
+    return;
+  }
+  haltMotion();
+  dropPlans();
+  if (kind == ABORT_REST) {
+    Serial.printf("RESTING %d\n", freeCredits());
+    beginIdleRest();
+  } else {
+    Serial.printf("STOPPED %d\n", freeCredits());
+  }
+}
+
+void startPlan() {
+  if (dropPending) dropPlans();
+  activePlan = planQueue.front();
+  if (activePlan == nullptr) {
+    startIdleRest();
+    return;
+  }
+  if (abortPending()) {
+    activePlan = nullptr;  // may be one it drops; handled on the next pass
+    return;
+  }
+  if (activePlan->framesReady.load(std::memory_order_acquire) == 0) {
+    if (activePlan->frameCount.load(std::memory_order_acquire) == 0) {
+      reportRejected(activePlan->seq, stats.cutStreams);  // stream truncated before any keyframe landed
+      planQueue.pop();
+    }
+    activePlan = nullptr;  // streamed sign whose first keyframe hasn't landed
+    return;
+  }
+  if (activePlan->held && !syncReleased(*activePlan)) {
+    activePlan = nullptr;  // still waiting for the other arm
+    return;
+  }
+  runPlan();
+}
+
+// Signal completion back to Python and release the plan's slot
+void retirePlan() {
+  if (idleResting) {
+    idleResting = false;  // not in the plan queue; nobody is waiting on it
+    activePlan = nullptr;
+    return;
+  }
+  idleRestDue = strcmp(activePlan->token, Arm::restToken) != 0;
+  idleSinceMs = millis();
+  if (activePlan->seq != 0) {
+    reportPlanEvent("DONE", activePlan->seq);
+  } else {
+    Serial.printf("ACK\n");
+  }
+  planQueue.pop();
+  activePlan = nullptr;
+}
+
+void finishPlan() {
+  retirePlan();
+  motionPhase = MOTION_IDLE;
+  startPlan();
+}
+
+// Place every channel kf drives at start + (target - start) * u, 0 <= u <= 1
+void interpolateServos(const Keyframe &kf, float u) {
+  ServoMask moved = 0;
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    int target = (kf.servoMask & (1u << i)) ? kf.servo[i] : joints.start[i];
+    int position = joints.start[i] + (int)lroundf((target - joints.start[i]) * u);
+    moved |= (ServoMask)(position != joints.position[i]) << i;
+    joints.position[i] = position;
+  }
+  joints.dirty |= moved;
+}
+
+// ================================
+// BLENDING
+// ================================
+// A timed sign whose successor is already in the plan queue hands over
+// without retiring to rest: the successor's lead-in becomes a cubic Hermite
+// segment that leaves the last keyframe with the velocity the sign was
+// moving at and reaches the successor's first keyframe with the velocity of
+// its first segment. The lead-in starts at max(last segment end, sign start
+// + duration): the final hold still runs in full, so a static sign or a
+// letter stays readable for its whole duration, and a sign whose last
+// keyframe lands on its duration flows on without stopping. Only plain
+// timed signs blend; step-timed and held (synchronized) plans still start
+// from rest.
+
+// Joint velocity (tenths of a degree per µs) across keyframe `index` of plan,
+// or 0 for channels that keyframe doesn't drive
+float segmentVelocity(MotionPlan &plan, int index, int channel) {
+  if (index < 1 || index >= plan.framesReady.load(std::memory_order_acquire)) return 0.0f;
+  const Keyframe &from = plan.frameAt(index - 1);
+  const Keyframe &to = plan.frameAt(index);
+  ServoMask both = from.servoMask & to.servoMask;
+  float seconds = to.time - from.time;
+  if (!(both & (1u << channel)) || seconds <= 0.0f) return 0.0f;
+  return (to.servo[channel] - from.servo[channel]) / (seconds * 1000000.0f);
+}
+
+// At the end of activePlan (its last segment, or the hold after it): hand
+// over to the next plan from startUs if one is queued. moving says the last
+// segment has just ended rather than a hold. Returns false to finish normally.
+bool blendIntoNext(unsigned long startUs, bool moving) {
+#if BLEND_SIGNS
+  MotionPlan *next = planQueue.second();
+  if (next == nullptr || dropPending || abortPending() || !next->timed || next->sampled || next->held ||
+      next->framesReady.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+
+  // Outgoing velocity: the segment that just ended, straight line start -> target
+  float velocity[TOTAL_SERVO_COUNT];
+  const Keyframe &last = activePlan->frameAt(activeFrame);
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    bool moved = moving && (last.servoMask & (1u << i)) && segmentDurationUs > 0;
+    velocity[i] = moved ? (joints.position[i] - joints.start[i]) / (float)segmentDurationUs : 0.0f;
+  }
+
+  retirePlan();
+  activePlan = planQueue.front();
+  runPlan();
+
+  segmentStartUs = startUs;
+  segmentDurationUs = max(segmentDurationUs, BLEND_MIN_MS * 1000UL);
+  segmentBlended = true;
+  const Keyframe &first = activePlan->frameAt(0);
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    bool driven = (first.servoMask & (1u << i)) != 0;
+    joints.startTangent[i] = driven ? velocity[i] * segmentDurationUs : 0.0f;
+    joints.endTangent[i] = segmentVelocity(*activePlan, 1, i) * segmentDurationUs;
+  }
+  return true;
+#else
+  (void)startUs;
+  (void)moving;
+  return false;
+#endif
+}
+
+// Hermite blend from joints.start to kf with the tangents set by blendIntoNext, 0 <= u <= 1
+void blendServos(const Keyframe &kf, float u) {
+  float u2 = u * u, u3 = u2 * u;
+  float h00 = 2 * u3 - 3 * u2 + 1, h10 = u3 - 2 * u2 + u;
+  float h01 = -2 * u3 + 3 * u2,    h11 = u3 - u2;
+  ServoMask moved = 0;
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    int target = (kf.servoMask & (1u << i)) ? kf.servo[i] : joints.start[i];
+    float p = h00 * joints.start[i] + h10 * joints.startTangent[i] +
+              h01 * target + h11 * joints.endTangent[i];
+    int position = constrain((int)lroundf(p), 0, SERVO_MAX_POS);
+    moved |= (ServoMask)(position != joints.position[i]) << i;
+    joints.position[i] = position;
+  }
+  joints.dirty |= moved;
+}
+
+// ================================
+// SAMPLED PLAYBACK
+// ================================
+// A sign compiled offline (`python -m src.fk_tool compile`) arrives as a
+// stream of setpoints at a fixed rate, already limited in speed and
+// acceleration and checked for collisions on the host. After the usual
+// timed lead-in into sample 0, each sample is written as it falls due: the
+// servos take its positions as they are and the shoulders get it as their
+// next target, with no interpolation or profiling here. A pass that comes
+// late skips straight to the newest due sample. When a streamed sample is
+// late the last one is held, and the schedule resumes from its arrival.
+
+// Start the sample clock at sample 0, which the lead-in has just reached
+void startSamples(unsigned long startUs) {
+  samplePlayback = true;
+  segmentStartUs = startUs;
+  shoulderRotation.setMaxSpeed(SHOULDER_MAX_SPEED);
+  shoulderFlexion.setMaxSpeed(SHOULDER_MAX_SPEED);
+}
+
+void applySample(const Keyframe &kf) {
+  ServoMask moved = 0;
+  for (int i = 0; i < TOTAL_SERVO_COUNT; i++) {
+    if (!(kf.servoMask & (1u << i))) continue;
+    moved |= (ServoMask)(kf.servo[i] != joints.position[i]) << i;
+    joints.position[i] = kf.servo[i];
+  }
+  joints.dirty |= moved;
+  if (kf.hasShoulder) {
+    shoulderRotation.moveTo(kf.rotationSteps);
+    shoulderFlexion.moveTo(kf.elevationSteps);
+  }
+}
+
+void updateSampledMotion(unsigned long now) {
+  unsigned long elapsed = now - segmentStartUs;
+  int written = activeFrame;
+  while (activeFrame + 1 < activePlan->frameCount) {
+    unsigned long dueUs = (unsigned long)(activePlan->frameAt(activeFrame + 1).time * 1000000.0f);
+    if (elapsed < dueUs) break;
+    if (!nextFrameReady()) {
+      segmentStartUs = now - dueUs;  // hold; the late sample falls due on arrival
+      break;
+    }
+    activeFrame++;
+  }
+
+  const Keyframe &kf = activePlan->frameAt(activeFrame);
+  if (activeFrame != written) {
+    applySample(kf);
+    activePlan->framesDone.store(activeFrame, std::memory_order_release);
+  }
+  if (activeFrame + 1 < activePlan->frameCount) return;
+
+  // Last sample written: hold it until the declared duration, as timed plans do
+  float holdSeconds = activePlan->duration - kf.time;
+  frameTimeUs = holdSeconds > 0.0f ? (unsigned long)(holdSeconds * 1000000.0f) : 0;
+  samplePlayback = false;
+  motionPhase = MOTION_DWELL;
+  dwellStartUs = segmentStartUs + (unsigned long)(kf.time * 1000000.0f);
+}
+
+void updateTimedMotion(unsigned long now) {
+  const Keyframe &kf = activePlan->frameAt(activeFrame);
+  unsigned long elapsed = now - segmentStartUs;
+  bool segmentDone = elapsed >= segmentDurationUs;
+  if (segmentDone && !streamStarved) stats.late.record(elapsed - segmentDurationUs);
+
+  if (segmentDone || now - lastServoStepUs >= DEFAULT_STEP_DELAY_US) {
+    lastServoStepUs = now;
+    float u = segmentDone ? 1.0f : (float)elapsed / (float)segmentDurationUs;
+    if (segmentBlended) {
+      blendServos(kf, u);
+    } else {
+      interpolateServos(kf, u);
+    }
+  }
+  if (!segmentDone) return;
+
+  // The next segment starts where this one was scheduled to end, so late
+  // passes don't accumulate into the sign's total length
+  unsigned long scheduledEndUs = segmentStartUs + segmentDurationUs;
+
+  if (activePlan->sampled) {
+    startSamples(scheduledEndUs);  // lead-in done; the samples take over
+    return;
+  }
+
+  if (activeFrame + 1 < activePlan->frameCount) {
+    // A late streamed keyframe restarts the schedule from now
+    bool onSchedule = !streamStarved;
+    if (!nextFrameReady()) return;
+    beginKeyframe(activeFrame + 1);
+    if (onSchedule) segmentStartUs = scheduledEndUs;
+    return;
+  }
+
+  // Hold the last keyframe until the sign's declared duration
+  float holdSeconds = activePlan->duration - kf.time;
+  frameTimeUs = holdSeconds > 0.0f ? (unsigned long)(holdSeconds * 1000000.0f) : 0;
+  if (frameTimeUs == 0 && blendIntoNext(scheduledEndUs, true)) return;
+  motionPhase = MOTION_DWELL;
+  dwellStartUs = scheduledEndUs;
+}
+
+void updateMotion() {
+  // Advance steppers on every pass (non-blocking; no-op with SHOULDER_STEP_TIMER)
+  shoulderRotation.run();
+  shoulderFlexion.run();
+  updateSyncTrigger();
+
+  unsigned long now = micros();
+  if (motionPhase != MOTION_IDLE && lastPassUs != 0) stats.loop.record(now - lastPassUs);
+  lastPassUs = (motionPhase != MOTION_IDLE) ? now : 0;
+  if (abortPending()) handleAbort();
+  if (idleResting && planQueue.front() != nullptr) cancelIdleRest();
+
+  switch (motionPhase) {
+    case MOTION_IDLE:
+      startPlan();
+      break;
+
+    case MOTION_MOVING: {
+      if (samplePlayback) {
+        updateSampledMotion(now);
+        break;
+      }
+      if (activePlan->timed) {
+        updateTimedMotion(now);
+        break;
+      }
+
+      const Keyframe &kf = activePlan->frameAt(activeFrame);
+
+      if (now - lastServoStepUs < DEFAULT_STEP_DELAY_US) break;
+      float dt = (now - lastServoStepUs) / 1000000.0f;
+      lastServoStepUs = now;
+      if (profileServos(kf, dt)) break;
+
+      // Servos settled — wait for the steppers to finish, then dwell
+      if (shoulderRotation.distanceToGo() == 0 && shoulderFlexion.distanceToGo() == 0) {
+        motionPhase = MOTION_DWELL;
+        dwellStartUs = now;
+      }
+      break;
+    }
+
+    case MOTION_DWELL:
+      if (now - dwellStartUs < frameTimeUs) break;
+
+      if (activePlan->timed) {
+        // Timed plans end on the clock, plus any stepper that is still landing
+        // (a late one starts the blend from now rather than mid-curve)
+        if (shoulderRotation.distanceToGo() == 0 && shoulderFlexion.distanceToGo() == 0) {
+          unsigned long holdEndUs = dwellStartUs + frameTimeUs;
+          if (!blendIntoNext(now - holdEndUs > DEFAULT_STEP_DELAY_US ? now : holdEndUs, false)) finishPlan();
+        }
+      } else if (activeFrame + 1 < activePlan->frameCount) {
+        if (nextFrameReady()) beginKeyframe(activeFrame + 1);
+      } else {
+        finishPlan();
+      }
+      break;
+  }
+
+  if (joints.dirty != 0 && now - lastServoFlushUs >= SERVO_PERIOD_US) {
+    lastServoFlushUs = now;
+    flushServos();
+  }
+}
+
+// ================================
+// TASKS
+// ================================
+// Receive + parse (ingest) and the motion engine run as separate FreeRTOS
+// tasks pinned to different cores, joined only by planQueue. A 2 KB JSON
+// parse on core 0 can no longer stall stepper pulses on core 1.
+//
+// Ownership: ingest owns Serial input, the command slots and the sign
+// cache; motion owns the servos, both shoulder steppers and activePlan.
+//
+// Both tasks write Serial output. Every line goes out in one Serial.printf,
+// a single UART driver write that the driver serializes, so a NEXT or BUSY
+// from ingest can never land inside a motion-side DONE. Never split a line
+// across print calls; println alone is two writes.
+
+// Receive new bytes and parse the next queued command into the plan queue
+void ingestCommands() {
+  // Receive new commands (non-blocking — take whatever bytes have arrived)
+  receiveSerial();
+
+  // Parse the next queued command while the current one is still moving
+  if (queueCount.load(std::memory_order_relaxed) > 0) {
+    MotionPlan *plan = planQueue.back();  // nullptr while the plan queue is full
+    const CommandSlot &slot = commandQueue[queueHead];
+    unsigned long parseStartUs = micros();
+    ParseResult result = parseCommand(slot, plan);
+    unsigned long now = micros();
+    if (result != PARSE_RETRY) stats.parse.record(now - parseStartUs);
+
+    switch (result) {
+      case PARSE_PLAN:
+        stats.rx.record(now - slot.receivedUs);
+        plan->publishedUs = now;
+        planQueue.publish();
+        releaseCommand();
+        break;
+      case PARSE_DROP:
+        releaseCommand();
+        break;
+      case PARSE_RETRY:
+        break;  // leave it queued
+    }
+  }
+}
+
+#if DUAL_CORE_TASKS
+void ingestTask(void *) {
+  for (;;) {
+    ingestCommands();
+    // Sleep a tick once caught up; the UART driver buffers meanwhile
+    if (Serial.available() == 0) vTaskDelay(1);
+  }
+}
+
+void motionTask(void *) {
+  for (;;) {
+    updateMotion();
+    // Spin while moving (step pulses are timed by polling); yield when idle
+    if (motionPhase == MOTION_IDLE && planQueue.front() == nullptr) vTaskDelay(1);
+  }
+}
+#endif
+
+// ================================
+// SETUP
+// ================================
+void setup() {
+  Serial.begin(BAUD_RATE);
+  delay(1500);
+
+  Serial.printf(ARM_TAG "Booting...\n");
+  loadChannelLimits();
+
+  // Attach hand, wrist and elbow servos at their starting positions
+  attachServos(joints.position);
+
+  // Shoulder stepper 1 (Rotation)
+  pinMode(Arm::rotationStepPin,   OUTPUT);
+  pinMode(Arm::rotationDirPin,    OUTPUT);
+  pinMode(Arm::rotationEnablePin, OUTPUT);
+  digitalWrite(Arm::rotationEnablePin, LOW);  // active LOW
+
+  // Shoulder stepper 2 (Flexion/Elevation)
+  pinMode(Arm::elevationStepPin,   OUTPUT);
+  pinMode(Arm::elevationDirPin,    OUTPUT);
+  pinMode(Arm::elevationEnablePin, OUTPUT);
+  digitalWrite(Arm::elevationEnablePin, LOW);  // active LOW
+
+  // Stepper config
+  shoulderRotation.setMaxSpeed(SHOULDER_MAX_SPEED);
+  shoulderRotation.setAcceleration(SHOULDER_ACCEL);
+  shoulderFlexion.setMaxSpeed(SHOULDER_MAX_SPEED);
+  shoulderFlexion.setAcceleration(SHOULDER_ACCEL);
+#if SHOULDER_STEP_TIMER
+  startStepTimer();
+#endif
+
+#if SYNC_TRIGGER_PIN >= 0
+  // Open drain with the input kept on, so digitalRead sees the wired-AND level
+  pinMode(SYNC_TRIGGER_PIN, INPUT_PULLUP | OUTPUT_OPEN_DRAIN);
+  digitalWrite(SYNC_TRIGGER_PIN, LOW);  // not ready
+#endif
+
+  bakeRestPose();
+  copyPlan(idleRestPlan, signCache[SIGN_ID_REST]);
+  idleRestPlan.held = false;
+  buildCommandFilter();
+
+#if DUAL_CORE_TASKS
+  xTaskCreatePinnedToCore(ingestTask, "ingest", INGEST_TASK_STACK, nullptr,
+                          INGEST_TASK_PRIORITY, nullptr, INGEST_TASK_CORE);
+  xTaskCreatePinnedToCore(motionTask, "motion", MOTION_TASK_STACK, nullptr,
+                          MOTION_TASK_PRIORITY, nullptr, MOTION_TASK_CORE);
+#endif
+
+  Serial.printf(ARM_TAG "Ready for motion commands.\n");
+  Serial.printf("CREDITS %d\n", MAX_QUEUE);
+}
+
+// ================================
+// MAIN LOOP
+// ================================
+// With DUAL_CORE_TASKS the tasks do all the work and loopTask retires.
+// Otherwise loop() never blocks: receiving, parsing the next command and
+// driving the current motion all happen on every pass.
+void loop() {
+#if DUAL_CORE_TASKS
+  vTaskDelete(nullptr);
+#else
+  ingestCommands();
+  updateMotion();
+#endif
+}
@@ -7,6 +7,9 @@ from typing import Generator
 class BaseSTT(ABC):
     """Interface that both Cloud STT and Local STT must implement."""
 
+    # The stop phrase that ended the last transcript stream, or None if it ended otherwise
+    stop_phrase = None
+
     @abstractmethod
     def start_stream(self) -> None:
         """Initialize audio stream. May be no-op for engines that handle this internally."""
@@ -22,6 +25,11 @@ class BaseSTT(ABC):
         """Yield transcript strings. Same format for both engines."""
         yield  # Make this a generator; subclasses will yield actual transcripts
 
+    def get_updates(self) -> Generator[tuple[str, bool], None, None]:
+        """Yield (text, is_final) pairs, interim hypotheses included. Engines without them yield only finals."""
+        for transcript in self.get_transcripts():
+            yield transcript, True
+
     @abstractmethod
     def is_ready(self) -> bool:
         """Check if engine is ready to transcribe."""
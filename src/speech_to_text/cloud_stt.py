@@ -19,7 +19,13 @@ class CloudSTT(BaseSTT):
 
     def get_transcripts(self) -> Generator[str, None, None]:
         """Yield from existing listen() generator."""
-        yield from listen()
+        self.stop_phrase = None
+        self.stop_phrase = yield from listen()
+
+    def get_updates(self) -> Generator[tuple[str, bool], None, None]:
+        """Yield from listen() with Google's interim results included."""
+        self.stop_phrase = None
+        self.stop_phrase = yield from listen(partials=True)
 
     def is_ready(self) -> bool:
         """Cloud STT is ready when instantiated."""
@@ -110,6 +110,7 @@ class LocalSTT(BaseSTT):
         self._worker_thread.start()
 
         trans_begun = False
+        self.stop_phrase = None
         try:
             while True:
                 try:
@@ -128,6 +129,7 @@ class LocalSTT(BaseSTT):
                 # Stop detection
                 elif any(phrase in transcript for phrase in STOP_PHRASES) and trans_begun:
                     print("[FRED] Stopping translation. Goodbye!")
+                    self.stop_phrase = next(phrase for phrase in STOP_PHRASES if phrase in transcript)
                     break
 
                 # Regular speech while active
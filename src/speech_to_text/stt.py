@@ -31,10 +31,12 @@ def mic_audio_stream():
         stream.close()
         p.terminate()
 
-def listen():
+def listen(partials=False):
     # Streams from the microphone and yields final transcript lines.
     # Activation: listens for 'start moving' / 'stop moving' phrases.
-    # Yields: str (final transcript text between activation and stop)
+    # Yields: str (final transcript text between activation and stop), or with
+    # partials=True (text, is_final) pairs that include the interim hypotheses
+    # Returns: the stop phrase that ended the stream
     config = speech.RecognitionConfig(
         encoding=speech.RecognitionConfig.AudioEncoding.LINEAR16,
         sample_rate_hertz=RATE,
@@ -53,13 +55,16 @@ def listen():
     stop_phrases = ["stop moving", "fred stop", "thank you fred"]
 
     for response in responses:
+        interim = []
         for result in response.results:
             if not result.alternatives:
                 continue
 
             transcript = result.alternatives[0].transcript.lower().strip()
 
-            if result.is_final:
+            if not result.is_final:
+                interim.append(transcript)
+            else:
                 # === Wake detection ===
                 if any(phrase in transcript for phrase in wake_phrases) and not trans_begun:
                     trans_begun = True
@@ -68,9 +73,15 @@ def listen():
                 # === Stop detection ===
                 elif any(phrase in transcript for phrase in stop_phrases) and trans_begun:
                     print("[FRED] Stopping translation. Goodbye!")
-                    return  # Gracefully stop listening
+                    return next(phrase for phrase in stop_phrases if phrase in transcript)  # Gracefully stop listening
 
                 # === Regular speech while active ===
                 elif trans_begun:
                     print(f"[FRED heard]: {transcript}")
-                    yield transcript
\ No newline at end of file
+                    yield (transcript, True) if partials else transcript
+
+        # === Interim hypothesis of the utterance so far (the results are consecutive pieces) ===
+        if partials and trans_begun and interim:
+            text = " ".join(interim)
+            if not any(phrase in text for phrase in wake_phrases + stop_phrases):
+                yield text, False
\ No newline at end of file
@@ -0,0 +1,363 @@
+"""
+Hardware-in-the-loop motion benchmark: replays sign suites through motion_io.run_motion
+against both controllers and writes a JSON report of end-to-end latency.
+
+Every command motion_io writes and every line the controllers print is timestamped at
+the serial layer (motion_io itself is unchanged), then matched up by sequence number:
+
+    write_ms        time spent in serial write() + flush() for the command
+    start_ms        command written -> firmware "STARTED" (includes queueing
+                    behind the sign that is still running)
+    run_ms          "STARTED" -> "DONE"
+    overhead_ms     run_ms minus the sign's declared duration (lead-in, holds,
+                    late keyframes)
+
+Each suite is queued in one go, like a sentence, so its throughput in signs per
+minute covers pipelining, blending and cache hits as they happen in use.
+
+Suites:
+    signs      every sign in src/signs/signs_to_seed.json, in file order
+    alphabet   the fingerspelling alphabet (src/cache/fingerspelling_cache.py)
+
+Usage:
+    python -B -m src.testing.bench_motion [options]
+
+Options:
+    --suite          Suites to run (default: signs alphabet).
+    --limit          Only the first N scripts of each suite.
+    --left-port      Serial port for left arm (default: ASL_LEFT_PORT env or COM8).
+    --right-port     Serial port for right arm (default: ASL_RIGHT_PORT env or COM4).
+    --out            Report path (default: eval/reports/bench_motion.json).
+
+No database is needed; signs are read straight from the seed file.
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import os
+import statistics
+import struct
+import threading
+import time
+from pathlib import Path
+
+import serial
+
+from src.cache.fingerspelling_cache import FINGERSPELL_CACHE
+from src.io import motion_io
+from src.io.fileIO import FileIOManager
+from src.io.motion_frames import (
+    FRAME_MAGIC, FRAME_TYPE_MOTION, FRAME_TYPE_PLAY, FRAME_TYPE_STORE, FRAME_TYPE_STREAM_BEGIN,
+    SIGN_ID_REST,
+)
+
+SEED_PATH = Path(__file__).resolve().parents[1] / "signs" / "signs_to_seed.json"
+DEFAULT_REPORT = Path("eval") / "reports" / "bench_motion.json"
+
+SETTLE_TIME = 1.0     # s of serial silence, after the last DONE, that ends a suite
+SUITE_MARGIN = 10.0   # s added to the suite's total declared duration before giving up
+JOIN_TIMEOUT = 8.0
+POLL_INTERVAL = 0.05
+
+
+def load_suite(name: str) -> list[dict]:
+    """Motion scripts of one benchmark suite, in replay order."""
+    if name == "signs":
+        with open(SEED_PATH, "r", encoding="utf-8") as f:
+            return json.load(f)
+    if name == "alphabet":
+        return [FINGERSPELL_CACHE[letter] for letter in sorted(FINGERSPELL_CACHE)]
+    raise ValueError(f"unknown suite: {name}")
+
+
+# ─────────────────────────────────────────────────────────────────────────────
+# SERIAL RECORDING
+# ─────────────────────────────────────────────────────────────────────────────
+
+def _plan_header(payload: bytes, offset: int) -> tuple[float, str]:
+    """(duration s, token) of the flags/duration/token header at payload[offset]."""
+    duration_ms, token_len = struct.unpack_from("<HB", payload, offset + 1)
+    start = offset + 4
+    return duration_ms / 1000.0, payload[start:start + token_len].decode("ascii", errors="replace")
+
+
+def parse_commands(data: bytes) -> list[tuple]:
+    """
+    Commands in one write: [(kind, number, token, duration)] where kind is "seq"
+    (a sign to run; number is its sequence number) or "store" (a sign-cache upload;
+    number is its cache id). PLAY frames come back with their cache id as token.
+    """
+    commands = []
+    if data[:1] != bytes([FRAME_MAGIC]):
+        # "<seq> {json}"
+        seq, _, line = data.partition(b" ")
+        try:
+            script = json.loads(line.decode("utf-8"))
+        except (UnicodeDecodeError, ValueError):
+            return commands
+        if seq.isdigit() and int(seq) and isinstance(script, dict):
+            commands.append(("seq", int(seq), script.get("token", "?"), float(script.get("duration", 0.0))))
+        return commands
+
+    pos = 0
+    while pos + 3 <= len(data) and data[pos] == FRAME_MAGIC:
+        length = data[pos + 1] | (data[pos + 2] << 8)
+        payload = data[pos + 3:pos + 3 + length]
+        pos += 3 + length + 2
+        if len(payload) < 3:
+            continue
+        kind = payload[0]
+        if kind in (FRAME_TYPE_MOTION, FRAME_TYPE_STREAM_BEGIN) and payload[1]:
+            duration, token = _plan_header(payload, 2)
+            commands.append(("seq", payload[1], token, duration))
+        elif kind == FRAME_TYPE_PLAY and payload[1]:
+            commands.append(("seq", payload[1], ("cache", payload[2]), None))
+        elif kind == FRAME_TYPE_STORE:
+            duration, token = _plan_header(payload, 2)
+            commands.append(("store", payload[1], token, duration))
+    return commands
+
+
+class Recorder:
+    """Timestamps commands and controller replies per arm and pairs them by seq."""
+
+    def __init__(self, ports: dict[str, str]):
+        self.arms = {port: arm for arm, port in ports.items()}
+        self.lock = threading.Lock()
+        self.rows: list[dict] = []
+        self.open_rows: dict[tuple, dict] = {}    # (arm, seq) -> row not yet DONE
+        self.unflushed: dict[str, list] = {}      # arm -> rows whose write isn't flushed yet
+        self.cache: dict[tuple, tuple] = {}       # (arm, cache id) -> (token, duration)
+        for arm in ports:
+            self.cache[(arm, SIGN_ID_REST)] = ("REST", None)  # baked into firmware, never uploaded
+        self.last_event = time.perf_counter()
+
+    def on_write(self, port: str, data: bytes, start: float, end: float) -> None:
+        arm = self.arms.get(port, port)
+        with self.lock:
+            self.last_event = end
+            for kind, number, token, duration in parse_commands(data):
+                if kind == "store":
+                    self.cache[(arm, number)] = (token, duration)
+                    continue
+                if isinstance(token, tuple):
+                    token, duration = self.cache.get((arm, token[1]), (f"#{token[1]}", None))
+                row = {"arm": arm, "seq": number, "token": token, "duration": duration,
+                       "write_start": start, "write_end": end, "started": None, "done": None,
+                       "rejected": False}
+                self.rows.append(row)
+                self.open_rows[(arm, number)] = row
+                self.unflushed.setdefault(arm, []).append(row)
+
+    def on_flush(self, port: str, end: float) -> None:
+        arm = self.arms.get(port, port)
+        with self.lock:
+            for row in self.unflushed.pop(arm, []):
+                row["write_end"] = end
+
+    def on_line(self, port: str, line: str, at: float) -> None:
+        fields = line.split()
+        if len(fields) < 2 or fields[0] not in ("STARTED", "DONE", "REJECTED") or not fields[1].isdigit():
+            return
+        arm = self.arms.get(port, port)
+        with self.lock:
+            self.last_event = at
+            row = self.open_rows.get((arm, int(fields[1])))
+            if row is None:
+                return
+            if fields[0] == "STARTED":
+                row["started"] = at
+                return
+            row["done"] = at
+            row["rejected"] = fields[0] == "REJECTED"
+            del self.open_rows[(arm, int(fields[1]))]
+
+    def pending(self) -> int:
+        with self.lock:
+            return len(self.open_rows)
+
+
+class RecordingSerial(serial.Serial):
+    """serial.Serial that reports every write, flush and line read to recorder."""
+
+    recorder: Recorder | None = None
+
+    def write(self, data):
+        start = time.perf_counter()
+        written = super().write(data)
+        if self.recorder is not None:
+            self.recorder.on_write(self.port, bytes(data), start, time.perf_counter())
+        return written
+
+    def flush(self):
+        super().flush()
+        if self.recorder is not None:
+            self.recorder.on_flush(self.port, time.perf_counter())
+
+    def readline(self, *args, **kwargs):
+        line = super().readline(*args, **kwargs)
+        if self.recorder is not None:
+            self.recorder.on_line(self.port, line.decode(errors="ignore").strip(), time.perf_counter())
+        return line
+
+
+# ─────────────────────────────────────────────────────────────────────────────
+# REPORT
+# ─────────────────────────────────────────────────────────────────────────────
+
+def _ms(start, end):
+    return None if start is None or end is None else round((end - start) * 1000.0, 2)
+
+
+def _distribution(values: list) -> dict | None:
+    values = sorted(v for v in values if v is not None)
+    if not values:
+        return None
+    return {
+        "n": len(values),
+        "mean": round(statistics.fmean(values), 2),
+        "p50": values[len(values) // 2],
+        "p95": values[min(len(values) - 1, int(len(values) * 0.95))],
+        "max": values[-1],
+    }
+
+
+def summarize(name: str, scripts: list[dict], rows: list[dict], elapsed: float) -> dict:
+    tokens = {str(s.get("token", "")) for s in scripts}
+    results = []
+    for row in rows:
+        run_ms = _ms(row["started"], row["done"])
+        overhead_ms = None
+        if run_ms is not None and row["duration"] is not None:
+            overhead_ms = round(run_ms - row["duration"] * 1000.0, 2)
+        results.append({
+            "arm": row["arm"],
+            "seq": row["seq"],
+            "token": row["token"],
+            "in_suite": row["token"] in tokens,
+            "duration_s": row["duration"],
+            "write_ms": _ms(row["write_start"], row["write_end"]),
+            "start_ms": _ms(row["write_start"], row["started"]),
+            "run_ms": run_ms,
+            "overhead_ms": overhead_ms,
+            "completed": row["done"] is not None and not row["rejected"],
+            "rejected": row["rejected"],
+        })
+
+    signs = [r for r in results if r["in_suite"]]
+    return {
+        "suite": name,
+        "scripts": len(scripts),
+        "commands": len(signs),
+        "completed": sum(r["completed"] for r in signs),
+        "elapsed_s": round(elapsed, 3),
+        "signs_per_minute": round(len(scripts) * 60.0 / elapsed, 2) if elapsed > 0 else None,
+        "write_ms": _distribution([r["write_ms"] for r in signs]),
+        "start_ms": _distribution([r["start_ms"] for r in signs]),
+        "run_ms": _distribution([r["run_ms"] for r in signs]),
+        "overhead_ms": _distribution([r["overhead_ms"] for r in signs]),
+        "results": results,
+    }
+
+
+# ─────────────────────────────────────────────────────────────────────────────
+# MAIN
+# ─────────────────────────────────────────────────────────────────────────────
+
+def run_suite(name: str, scripts: list[dict], file_io: FileIOManager, recorder: Recorder) -> dict:
+    """Queue a whole suite, wait for every command to finish, and summarize it."""
+    with recorder.lock:
+        first_row = len(recorder.rows)
+    deadline = time.perf_counter() + SUITE_MARGIN + sum(motion_io.ack_budget(s) for s in scripts)
+
+    print(f"[BENCH] Suite '{name}': {len(scripts)} scripts.")
+    start = time.perf_counter()
+    for script in scripts:
+        file_io.push_motion_script(script)
+
+    while time.perf_counter() < deadline:
+        time.sleep(POLL_INTERVAL)
+        if not file_io.motion_queue.empty() or recorder.pending():
+            continue
+        if time.perf_counter() - recorder.last_event >= SETTLE_TIME:
+            break
+    else:
+        print(f"[BENCH] ⚠ Suite '{name}' timed out with {recorder.pending()} command(s) unfinished.")
+
+    with recorder.lock:
+        rows = recorder.rows[first_row:]
+        finished = [r["done"] for r in rows if r["done"] is not None]
+    end = max(finished) if finished else time.perf_counter()
+    summary = summarize(name, scripts, rows, end - start)
+    print(
+        f"[BENCH] Suite '{name}': {summary['completed']}/{summary['commands']} commands completed, "
+        f"{summary['signs_per_minute']} signs/min."
+    )
+    return summary
+
+
+def main(argv: list[str] | None = None) -> None:
+    parser = argparse.ArgumentParser(
+        description="Replay sign suites through motion_io and report end-to-end latency.",
+    )
+    parser.add_argument("--suite", nargs="+", choices=("signs", "alphabet"), default=["signs", "alphabet"])
+    parser.add_argument("--limit", type=int, default=None, help="Only the first N scripts of each suite.")
+    parser.add_argument(
+        "--left-port",
+        default=os.getenv("ASL_LEFT_PORT", "COM8").strip(),
+        help="Left arm serial port (default: ASL_LEFT_PORT or COM8).",
+    )
+    parser.add_argument(
+        "--right-port",
+        default=os.getenv("ASL_RIGHT_PORT", "COM4").strip(),
+        help="Right arm serial port (default: ASL_RIGHT_PORT or COM4).",
+    )
+    parser.add_argument("--out", type=Path, default=DEFAULT_REPORT, help="Report path (JSON).")
+    args = parser.parse_args(argv)
+
+    recorder = Recorder({"LEFT": args.left_port, "RIGHT": args.right_port})
+    RecordingSerial.recorder = recorder
+    motion_io.serial.Serial = RecordingSerial  # connect_serial() opens ports through this
+
+    file_io = FileIOManager()
+    motion_thread = threading.Thread(
+        target=motion_io.run_motion,
+        args=(file_io,),
+        kwargs={"left_port": args.left_port, "right_port": args.right_port},
+        daemon=True,
+        name="motion",
+    )
+    motion_thread.start()
+
+    suites = []
+    try:
+        for name in args.suite:
+            scripts = load_suite(name)[:args.limit]
+            suites.append(run_suite(name, scripts, file_io, recorder))
+    except KeyboardInterrupt:
+        print("\n[BENCH] Interrupted; writing what was measured.")
+    finally:
+        file_io.shutdown.set()
+        motion_thread.join(timeout=JOIN_TIMEOUT)
+
+    report = {
+        "created": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "ports": {"LEFT": args.left_port, "RIGHT": args.right_port},
+        "motion_io": {
+            "WIRE_FORMAT": motion_io.WIRE_FORMAT,
+            "TIMED_PLAYBACK": motion_io.TIMED_PLAYBACK,
+            "DEVICE_SIGN_CACHE": motion_io.DEVICE_SIGN_CACHE,
+            "MOTION_WINDOW": motion_io.MOTION_WINDOW,
+            "SYNC_START": motion_io.SYNC_START,
+        },
+        "suites": suites,
+    }
+    args.out.parent.mkdir(parents=True, exist_ok=True)
+    with open(args.out, "w", encoding="utf-8") as f:
+        json.dump(report, f, indent=2)
+    print(f"[BENCH] Report written to {args.out}.")
+
+
+if __name__ == "__main__":
+    main()
@@ -33,7 +33,7 @@ from bson import ObjectId
 from src.database.db_connection import DatabaseConnection
 from src.io.fileIO import FileIOManager
 from src.io.motion_io import run_motion
-from src.io.sign_resolution import enqueue_motions_for_token, motions_for_token
+from src.io.sign_resolution import enqueue_motions_for_token, motions_for_token, resolve_signs
 
 JOIN_TIMEOUT = 1.0
 JOIN_MAX_WAIT = 8.0
@@ -60,6 +60,7 @@ def _process_line(line: str, file_io: FileIOManager, *, dry_run: bool) -> None:
     tokens = line.split()
     if not tokens:
         return
+    resolve_signs(tokens)
     for token in tokens:
         if dry_run:
             scripts = motions_for_token(token)